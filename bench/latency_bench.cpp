@@ -0,0 +1,258 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+// Input to photon latency benchmark: injects D-pad presses from another
+// thread, at random times, and measures how long it takes until the frame
+// showing the resulting focus change has been presented
+//
+// Usage: borealis_latency_bench [--presses n] [--output file.json]
+//
+// Built with BRLS_FINISH_AT_SWAP, so that every frame is waited for
+// with glFinish() right after the swap. Needs a visible window for
+// vsync to apply, every configuration below is measured in turn
+// and the results are written as JSON (latencies in ms)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <borealis.hpp>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define DEFAULT_PRESSES 100
+#define WARMUP_FRAMES 60
+#define PRESS_TIMEOUT 1000000 // us
+#define MIN_PRESS_INTERVAL 5 // ms
+#define MAX_PRESS_INTERVAL 60 // ms
+
+using namespace brls;
+
+struct LatencyConfig
+{
+    std::string name;
+    unsigned maximumFPS; // 0 for unlimited
+    bool vsync;
+};
+
+struct LatencyResult
+{
+    LatencyConfig config;
+    std::vector<double> latencies; // ms
+    unsigned timeouts;
+};
+
+static std::vector<LatencyConfig> configs = {
+    { "vsync_60fps", 60, true },
+    { "vsync_unlimited", 0, true },
+    { "novsync_60fps", 60, false },
+    { "novsync_120fps", 120, false },
+    { "novsync_unlimited", 0, false },
+};
+
+static std::atomic<retro_time_t> pendingPress(0); // injection time of the press waiting for its frame, 0 if none
+static bool focusChanged = false;
+
+// Presses the D-pad at random times, waiting for every
+// press to be presented (or to time out) before releasing it
+static void inject(unsigned presses, std::atomic<unsigned>* timeouts, std::atomic<bool>* done)
+{
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<int> interval(MIN_PRESS_INTERVAL, MAX_PRESS_INTERVAL);
+
+    for (unsigned i = 0; i < presses; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval(rng)));
+
+        // Go back and forth between the first two items
+        int button = i % 2 == 0 ? GLFW_GAMEPAD_BUTTON_DPAD_DOWN : GLFW_GAMEPAD_BUTTON_DPAD_UP;
+
+        retro_time_t pressTime = cpu_features_get_time_usec();
+        pendingPress.store(pressTime);
+        Application::injectButton(button, true, pressTime);
+
+        while (pendingPress.load() != 0)
+        {
+            if (cpu_features_get_time_usec() - pressTime > PRESS_TIMEOUT)
+            {
+                pendingPress.store(0);
+                (*timeouts)++;
+                break;
+            }
+
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+
+        Application::injectButton(button, false);
+    }
+
+    done->store(true);
+}
+
+static LatencyResult runConfig(LatencyConfig config, unsigned presses)
+{
+    LatencyResult result;
+    result.config = config;
+
+    Application::setMaximumFPS(config.maximumFPS);
+    Application::setVSync(config.vsync);
+
+    for (unsigned i = 0; i < WARMUP_FRAMES; i++)
+        Application::mainLoop();
+
+    std::atomic<unsigned> timeouts(0);
+    std::atomic<bool> done(false);
+
+    focusChanged = false;
+    std::thread injector(inject, presses, &timeouts, &done);
+
+    while (!done.load())
+    {
+        if (!Application::mainLoop())
+            break;
+
+        // The frame that changed the focus, and started highlighting
+        // the new one, has just been presented
+        retro_time_t pressTime = pendingPress.load();
+
+        if (focusChanged && pressTime != 0)
+        {
+            result.latencies.push_back((cpu_features_get_time_usec() - pressTime) / 1000.0);
+            pendingPress.store(0);
+        }
+
+        focusChanged = false;
+    }
+
+    injector.join();
+
+    result.timeouts = timeouts.load();
+    return result;
+}
+
+static void writeResults(FILE* file, std::vector<LatencyResult>& results)
+{
+    fprintf(file, "{\n  \"unit\": \"ms\",\n  \"configs\": [\n");
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        LatencyResult* result = &results[i];
+
+        std::vector<double> sorted = result->latencies;
+        std::sort(sorted.begin(), sorted.end());
+
+        double sum = 0.0;
+        for (double latency : sorted)
+            sum += latency;
+
+        fprintf(file, "    {\n");
+        fprintf(file, "      \"name\": \"%s\",\n", result->config.name.c_str());
+        fprintf(file, "      \"maximum_fps\": %u,\n", result->config.maximumFPS);
+        fprintf(file, "      \"vsync\": %s,\n", result->config.vsync ? "true" : "false");
+        fprintf(file, "      \"presses\": %zu,\n", sorted.size());
+        fprintf(file, "      \"timeouts\": %u,\n", result->timeouts);
+        fprintf(file, "      \"latency\": ");
+
+        if (sorted.empty())
+        {
+            fprintf(file, "null\n");
+        }
+        else
+        {
+            fprintf(file, "{ \"min\": %.4f, \"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f }\n",
+                sorted.front(),
+                sum / sorted.size(),
+                sorted[sorted.size() / 2],
+                sorted[sorted.size() * 90 / 100],
+                sorted[sorted.size() * 99 / 100],
+                sorted.back());
+        }
+
+        fprintf(file, "    }%s\n", i + 1 < results.size() ? "," : "");
+    }
+
+    fprintf(file, "  ]\n}\n");
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned presses   = DEFAULT_PRESSES;
+    const char* output = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--presses") == 0 && i + 1 < argc)
+            presses = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else
+        {
+            fprintf(stderr, "Usage: %s [--presses n] [--output file.json]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Keep stdout for the results
+    Logger::setLogLevel(LogLevel::ERROR);
+
+    if (!Application::init("Borealis latency benchmark"))
+    {
+        Logger::error("Unable to init Borealis application");
+        return EXIT_FAILURE;
+    }
+
+    List* list = new List();
+    for (unsigned i = 0; i < 20; i++)
+        list->addView(new ListItem("Item " + std::to_string(i)));
+
+    Application::pushView(list);
+
+    Application::getGlobalFocusChangeEvent()->subscribe([](View* view) { focusChanged = true; });
+
+    std::vector<LatencyResult> results;
+
+    for (LatencyConfig& config : configs)
+    {
+        fprintf(stderr, "Running %s...\n", config.name.c_str());
+        results.push_back(runConfig(config, presses));
+    }
+
+    FILE* file = output ? fopen(output, "w") : stdout;
+
+    if (!file)
+    {
+        fprintf(stderr, "Cannot open %s\n", output);
+        return EXIT_FAILURE;
+    }
+
+    writeResults(file, results);
+
+    if (output)
+        fclose(file);
+
+    Application::quit();
+    Application::mainLoop();
+
+    return EXIT_SUCCESS;
+}
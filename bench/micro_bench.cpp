@@ -0,0 +1,724 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+// Microbenchmarks of the core hot paths, without any window or GPU:
+// nanovg runs on a null renderer, so only the CPU side is measured
+//
+// Usage: borealis_microbench [--filter substring] [--samples n] [--output file.json] [--cjk-font file.ttf]
+//
+// Every benchmark is calibrated so that one sample lasts about TARGET_SAMPLE_NS,
+// then timed over a number of samples. The summary is printed on stderr
+// and the results are written as JSON (ns per operation) to stdout or to the output file
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <borealis.hpp>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define TARGET_SAMPLE_NS 5000000.0 // 5ms
+#define DEFAULT_SAMPLES 25
+#define WARMUP_SAMPLES 2
+
+using namespace brls;
+
+// Keeps the compiler from optimizing away a computed value
+template <typename T>
+static inline void doNotOptimize(T const& value)
+{
+    asm volatile(""
+                 :
+                 : "r,m"(value)
+                 : "memory");
+}
+
+namespace brls
+{
+
+// Access to the private Application entry points that are timed
+class MicroBench
+{
+  public:
+    static bool handleAction(char button)
+    {
+        return Application::handleAction(button);
+    }
+};
+
+} // namespace brls
+
+struct Benchmark
+{
+    std::string name;
+
+    std::function<void()> setup; // optional, untimed, before every sample
+    std::function<void(uint64_t iterations)> run;
+    std::function<void()> teardown; // optional, untimed, after every sample
+
+    // Cap for benchmarks that mutate their state on every operation
+    uint64_t maxIterations = UINT64_MAX;
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    uint64_t iterations;
+    std::vector<double> samples; // ns per operation
+
+    double median, mean, stddev, min, max;
+    double ci95; // half width of the 95% confidence interval of the mean
+};
+
+static double runSample(Benchmark* benchmark, uint64_t iterations)
+{
+    if (benchmark->setup)
+        benchmark->setup();
+
+    auto start = std::chrono::steady_clock::now();
+    benchmark->run(iterations);
+    auto end = std::chrono::steady_clock::now();
+
+    if (benchmark->teardown)
+        benchmark->teardown();
+
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// Finds the number of iterations for one sample to last about TARGET_SAMPLE_NS
+static uint64_t calibrate(Benchmark* benchmark)
+{
+    uint64_t iterations = 1;
+
+    while (true)
+    {
+        double elapsed = runSample(benchmark, iterations);
+
+        if (iterations >= benchmark->maxIterations)
+            return benchmark->maxIterations;
+
+        if (elapsed >= TARGET_SAMPLE_NS / 10.0)
+        {
+            double perOp = elapsed / iterations;
+            uint64_t target = (uint64_t)(TARGET_SAMPLE_NS / perOp);
+            return std::max((uint64_t)1, std::min(target, benchmark->maxIterations));
+        }
+
+        iterations = std::min(iterations * 10, benchmark->maxIterations);
+    }
+}
+
+// Two-sided Student's t quantiles at 95%, for 1 to 30 degrees of freedom
+static double studentT95(size_t df)
+{
+    static const double table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+
+    if (df == 0)
+        return 0.0;
+
+    if (df <= 30)
+        return table[df - 1];
+
+    return 1.96;
+}
+
+static BenchmarkResult runBenchmark(Benchmark* benchmark, unsigned samples)
+{
+    BenchmarkResult result;
+    result.name       = benchmark->name;
+    result.iterations = calibrate(benchmark);
+
+    for (unsigned i = 0; i < WARMUP_SAMPLES; i++)
+        runSample(benchmark, result.iterations);
+
+    for (unsigned i = 0; i < samples; i++)
+        result.samples.push_back(runSample(benchmark, result.iterations) / result.iterations);
+
+    std::vector<double> sorted = result.samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    size_t count  = sorted.size();
+    result.min    = sorted.front();
+    result.max    = sorted.back();
+    result.median = count % 2 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+
+    double sum = 0.0;
+    for (double sample : sorted)
+        sum += sample;
+
+    result.mean = sum / count;
+
+    double squares = 0.0;
+    for (double sample : sorted)
+        squares += (sample - result.mean) * (sample - result.mean);
+
+    result.stddev = count > 1 ? sqrt(squares / (count - 1)) : 0.0;
+    result.ci95   = studentT95(count - 1) * result.stddev / sqrt((double)count);
+
+    return result;
+}
+
+// Null nanovg renderer: paths are still flattened and tessellated,
+// glyphs still rasterized, but nothing reaches a GPU
+namespace null_renderer
+{
+
+static std::vector<std::pair<int, int>> textures; // sizes, by image id - 1
+
+static int renderCreate(void* uptr)
+{
+    return 1;
+}
+
+static int renderCreateTexture(void* uptr, int type, int w, int h, int imageFlags, const unsigned char* data)
+{
+    textures.push_back({ w, h });
+    return (int)textures.size();
+}
+
+static int renderDeleteTexture(void* uptr, int image)
+{
+    return 1;
+}
+
+static int renderUpdateTexture(void* uptr, int image, int x, int y, int w, int h, const unsigned char* data)
+{
+    return 1;
+}
+
+static int renderGetTextureSize(void* uptr, int image, int* w, int* h)
+{
+    if (image < 1 || image > (int)textures.size())
+        return 0;
+
+    *w = textures[image - 1].first;
+    *h = textures[image - 1].second;
+    return 1;
+}
+
+static void renderViewport(void* uptr, float width, float height, float devicePixelRatio)
+{
+}
+
+static void renderCancel(void* uptr)
+{
+}
+
+static void renderFlush(void* uptr)
+{
+}
+
+static void renderFill(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe, const float* bounds, const NVGpath* paths, int npaths)
+{
+}
+
+static void renderStroke(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe, float strokeWidth, const NVGpath* paths, int npaths)
+{
+}
+
+static void renderTriangles(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, const NVGvertex* verts, int nverts)
+{
+}
+
+static void renderDelete(void* uptr)
+{
+}
+
+} // namespace null_renderer
+
+static std::string cjkFontPath;
+
+static NVGcontext* createContext(FontStash* stash)
+{
+    NVGparams params;
+    memset(&params, 0, sizeof(params));
+
+    params.edgeAntiAlias        = 1;
+    params.renderCreate         = null_renderer::renderCreate;
+    params.renderCreateTexture  = null_renderer::renderCreateTexture;
+    params.renderDeleteTexture  = null_renderer::renderDeleteTexture;
+    params.renderUpdateTexture  = null_renderer::renderUpdateTexture;
+    params.renderGetTextureSize = null_renderer::renderGetTextureSize;
+    params.renderViewport       = null_renderer::renderViewport;
+    params.renderCancel         = null_renderer::renderCancel;
+    params.renderFlush          = null_renderer::renderFlush;
+    params.renderFill           = null_renderer::renderFill;
+    params.renderStroke         = null_renderer::renderStroke;
+    params.renderTriangles      = null_renderer::renderTriangles;
+    params.renderDelete         = null_renderer::renderDelete;
+
+    NVGcontext* vg = nvgCreateInternal(&params);
+
+    if (!vg)
+    {
+        fprintf(stderr, "Cannot create the nanovg context\n");
+        exit(1);
+    }
+
+    stash->regular = nvgCreateFont(vg, "regular", BOREALIS_ASSET("inter/Inter-Switch.ttf"));
+
+    if (stash->regular < 0)
+    {
+        fprintf(stderr, "Cannot load the regular font, the benchmark must run from the repository root\n");
+        exit(1);
+    }
+
+    // Without a CJK font, CJK text goes through the fallback lookup and misses
+    if (!cjkFontPath.empty())
+    {
+        stash->korean = nvgCreateFont(vg, "korean", cjkFontPath.c_str());
+
+        if (stash->korean >= 0)
+            nvgAddFallbackFontId(vg, stash->regular, stash->korean);
+    }
+
+    return vg;
+}
+
+static void destroyContext(NVGcontext* vg)
+{
+    nvgDeleteInternal(vg);
+}
+
+// Animations
+
+static const unsigned ANIMATIONS_COUNTS[] = { 10, 1000, 100000 };
+static const uint64_t MAX_PUSHED_ANIMATIONS = 100000;
+
+static std::vector<float> subjects;
+
+static void pushAnimation(float* subject)
+{
+    menu_animation_ctx_entry_t entry;
+    entry.easing_enum  = EASING_OUT_QUAD;
+    entry.tag          = (uintptr_t)subject;
+    entry.duration     = 1000000.0f; // never finishes during a sample
+    entry.target_value = 1.0f;
+    entry.subject      = subject;
+    entry.cb           = nullptr;
+    entry.tick         = nullptr;
+    entry.userdata     = nullptr;
+
+    menu_animation_push(&entry);
+}
+
+static void addAnimationBenchmarks(std::vector<Benchmark>* benchmarks)
+{
+    for (unsigned count : ANIMATIONS_COUNTS)
+    {
+        std::string suffix = "/" + std::to_string(count);
+
+        auto fill = [count]() {
+            subjects.assign(count + MAX_PUSHED_ANIMATIONS, 0.0f);
+            for (unsigned i = 0; i < count; i++)
+                pushAnimation(&subjects[i]);
+        };
+
+        // Pushing on top of count running tweens
+        benchmarks->push_back({ "animation_push" + suffix,
+            fill,
+            [count](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; i++)
+                    pushAnimation(&subjects[count + i]);
+            },
+            menu_animation_free,
+            MAX_PUSHED_ANIMATIONS });
+
+        // One update of count running tweens
+        benchmarks->push_back({ "animation_update" + suffix,
+            fill,
+            [](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; i++)
+                    menu_animation_update();
+            },
+            menu_animation_free });
+
+        // Killing a tween among count running tweens, then pushing
+        // it again to keep their count constant
+        benchmarks->push_back({ "animation_kill_by_tag" + suffix,
+            fill,
+            [count](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    float* subject             = &subjects[i % count];
+                    menu_animation_ctx_tag tag = (uintptr_t)subject;
+                    menu_animation_kill_by_tag(&tag);
+                    pushAnimation(subject);
+                }
+            },
+            menu_animation_free });
+    }
+}
+
+// Events
+
+static void addEventBenchmarks(std::vector<Benchmark>* benchmarks)
+{
+    static Event<int> event;
+    static int sink;
+
+    for (unsigned subscribers : { 1u, 16u, 1000u })
+    {
+        benchmarks->push_back({ "event_fire/" + std::to_string(subscribers),
+            [subscribers]() {
+                for (unsigned i = 0; i < subscribers; i++)
+                    event.subscribe([](int value) { sink += value; });
+            },
+            [](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; i++)
+                    event.fire((int)i);
+
+                doNotOptimize(sink);
+            },
+            []() { event = Event<int>(); } });
+    }
+}
+
+// Layout and text
+
+static NVGcontext* vg;
+static FontStash stash;
+static Style style;
+
+static void addLayoutBenchmarks(std::vector<Benchmark>* benchmarks)
+{
+    static BoxLayout* box;
+
+    for (unsigned children : { 10u, 100u, 1000u })
+    {
+        benchmarks->push_back({ "box_layout/" + std::to_string(children),
+            [children]() {
+                box = new BoxLayout(BoxLayoutOrientation::VERTICAL);
+                box->setBoundaries(0, 0, 1280, 720);
+
+                for (unsigned i = 0; i < children; i++)
+                {
+                    Rectangle* rectangle = new Rectangle(nvgRGB(0, 0, 0));
+                    rectangle->setHeight(40);
+                    box->addView(rectangle);
+                }
+            },
+            [](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; i++)
+                    box->layout(vg, &style, &stash);
+            },
+            []() { delete box; } });
+    }
+
+    static Label* label;
+
+    static const std::pair<std::string, std::string> texts[] = {
+        { "ascii", "The quick brown fox jumps over the lazy dog, then keeps running around the field until it gets tired and falls asleep under a tree" },
+        { "cjk", "\xec\x95\x88\xeb\x85\x95\xed\x95\x98\xec\x84\xb8\xec\x9a\x94 \xe3\x81\x93\xe3\x82\x93\xe3\x81\xab\xe3\x81\xa1\xe3\x81\xaf \xe4\xbd\xa0\xe5\xa5\xbd\xe4\xb8\x96\xe7\x95\x8c \xec\x95\x88\xeb\x85\x95\xed\x95\x98\xec\x84\xb8\xec\x9a\x94 \xe3\x81\x93\xe3\x82\x93\xe3\x81\xab\xe3\x81\xa1\xe3\x81\xaf \xe4\xbd\xa0\xe5\xa5\xbd\xe4\xb8\x96\xe7\x95\x8c \xec\x95\x88\xeb\x85\x95\xed\x95\x98\xec\x84\xb8\xec\x9a\x94 \xe3\x81\x93\xe3\x82\x93\xe3\x81\xab\xe3\x81\xa1\xe3\x81\xaf" },
+    };
+
+    for (const auto& text : texts)
+    {
+        for (bool multiline : { false, true })
+        {
+            std::string textValue = text.second;
+
+            benchmarks->push_back({ "label_layout/" + text.first + (multiline ? "/multiline" : "/single"),
+                [textValue, multiline]() {
+                    label = new Label(LabelStyle::REGULAR, textValue, multiline);
+                    label->setFontSize(20);
+                    label->setBoundaries(0, 0, 400, 0);
+                },
+                [](uint64_t iterations) {
+                    for (uint64_t i = 0; i < iterations; i++)
+                    {
+                        label->setWidth(400);
+                        label->layout(vg, &style, &stash);
+                    }
+                },
+                []() { delete label; } });
+        }
+    }
+}
+
+// Glyph cache, through the drawing of a single glyph
+// (the glyph lookup itself is internal to fontstash, and measuring
+// text only asks for metrics, without rasterizing missing glyphs)
+
+static void addGlyphBenchmarks(std::vector<Benchmark>* benchmarks)
+{
+    static NVGcontext* glyphsContext;
+    static FontStash glyphsStash;
+
+    auto teardown = []() {
+        nvgEndFrame(glyphsContext);
+        destroyContext(glyphsContext);
+    };
+
+    benchmarks->push_back({ "glyph/hit",
+        []() {
+            glyphsContext = createContext(&glyphsStash);
+            nvgBeginFrame(glyphsContext, 1280, 720, 1.0f);
+            nvgFontFaceId(glyphsContext, glyphsStash.regular);
+            nvgFontSize(glyphsContext, 20.0f);
+            nvgText(glyphsContext, 0, 0, "A", nullptr);
+        },
+        [](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++)
+                doNotOptimize(nvgText(glyphsContext, 0, 0, "A", nullptr));
+        },
+        teardown });
+
+    // Every operation asks for a glyph that's not in the cache yet:
+    // a new codepoint and size pair, rasterized into the atlas
+    benchmarks->push_back({ "glyph/miss",
+        []() {
+            glyphsContext = createContext(&glyphsStash);
+            nvgBeginFrame(glyphsContext, 1280, 720, 1.0f);
+            nvgFontFaceId(glyphsContext, glyphsStash.regular);
+        },
+        [](uint64_t iterations) {
+            char glyph[2] = { 0, 0 };
+
+            for (uint64_t i = 0; i < iterations; i++)
+            {
+                glyph[0] = (char)('!' + i % 94);
+                nvgFontSize(glyphsContext, 12.0f + (i / 94) * 0.5f);
+                doNotOptimize(nvgText(glyphsContext, 0, 0, glyph, nullptr));
+            }
+        },
+        teardown,
+        94 * 4 }); // keep the atlas from filling up
+}
+
+// Actions dispatch on the focus path
+
+// Focused leaf of the actions benchmarks
+class FocusableRectangle : public Rectangle
+{
+  public:
+    FocusableRectangle()
+        : Rectangle(nvgRGB(0, 0, 0))
+    {
+    }
+
+    View* getDefaultFocus() override
+    {
+        return this;
+    }
+};
+
+static void addActionsBenchmarks(std::vector<Benchmark>* benchmarks)
+{
+    static BoxLayout* root;
+    static View* focus;
+    static ActionTable table;
+
+    for (unsigned depth : { 4u, 16u, 64u })
+    {
+        auto setup = [depth]() {
+            root           = new BoxLayout(BoxLayoutOrientation::VERTICAL);
+            BoxLayout* box = root;
+
+            // Every level has a few actions, only the root consumes A
+            root->registerAction("Root", Key::A, [] { return true; });
+
+            for (unsigned i = 0; i < depth; i++)
+            {
+                BoxLayout* child = new BoxLayout(BoxLayoutOrientation::HORIZONTAL);
+                child->registerAction("Pass", Key::A, [] { return false; });
+                child->registerAction("Back", Key::B, [] { return false; });
+                child->registerAction("Menu", Key::PLUS, [] { return false; }, true);
+
+                box->addView(child);
+                box = child;
+            }
+
+            focus = new FocusableRectangle();
+            box->addView(focus);
+
+            table.build(focus);
+        };
+
+        std::string suffix = "/" + std::to_string(depth);
+
+        // Rebuilding the table, as done on every focus change
+        benchmarks->push_back({ "actions_build" + suffix,
+            setup,
+            [](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; i++)
+                    table.build(focus);
+            },
+            []() { delete root; } });
+
+        // Dispatching a key from the focused view up to the root, through
+        // Application::handleAction() itself (it only needs the focus)
+        benchmarks->push_back({ "actions_dispatch" + suffix,
+            [setup]() {
+                setup();
+                Application::giveFocus(focus);
+            },
+            [](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; i++)
+                    MicroBench::handleAction((char)Key::A);
+            },
+            []() {
+                Application::giveFocus(nullptr);
+                delete root;
+
+                // Drop the highlight animations of the deleted views
+                menu_animation_free();
+            } });
+    }
+}
+
+// Paths tessellation
+
+static void addTessellationBenchmarks(std::vector<Benchmark>* benchmarks)
+{
+    for (float radius : { 0.0f, 4.0f, 32.0f })
+    {
+        benchmarks->push_back({ "rounded_rect_fill/" + std::to_string((int)radius),
+            nullptr,
+            [radius](uint64_t iterations) {
+                nvgBeginFrame(vg, 1280, 720, 1.0f);
+
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    float offset = (float)(i % 64);
+
+                    nvgBeginPath(vg);
+                    nvgRoundedRect(vg, 100 + offset, 100, 400, 70, radius);
+                    nvgFillColor(vg, nvgRGB(255, 255, 255));
+                    nvgFill(vg);
+                }
+
+                nvgEndFrame(vg);
+            },
+            nullptr });
+    }
+}
+
+static void writeResults(FILE* file, std::vector<BenchmarkResult>& results, unsigned samples)
+{
+    fprintf(file, "{\n  \"unit\": \"ns/op\",\n  \"samples\": %u,\n  \"benchmarks\": [\n", samples);
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        BenchmarkResult* result = &results[i];
+
+        fprintf(file, "    {\n");
+        fprintf(file, "      \"name\": \"%s\",\n", result->name.c_str());
+        fprintf(file, "      \"iterations\": %llu,\n", (unsigned long long)result->iterations);
+        fprintf(file, "      \"median\": %.3f,\n", result->median);
+        fprintf(file, "      \"mean\": %.3f,\n", result->mean);
+        fprintf(file, "      \"stddev\": %.3f,\n", result->stddev);
+        fprintf(file, "      \"ci95\": %.3f,\n", result->ci95);
+        fprintf(file, "      \"min\": %.3f,\n", result->min);
+        fprintf(file, "      \"max\": %.3f\n", result->max);
+        fprintf(file, "    }%s\n", i + 1 < results.size() ? "," : "");
+    }
+
+    fprintf(file, "  ]\n}\n");
+}
+
+int main(int argc, char* argv[])
+{
+    std::string filter;
+    unsigned samples   = DEFAULT_SAMPLES;
+    const char* output = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+            samples = std::max(2, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else if (strcmp(argv[i], "--cjk-font") == 0 && i + 1 < argc)
+            cjkFontPath = argv[++i];
+        else
+        {
+            fprintf(stderr, "Usage: %s [--filter substring] [--samples n] [--output file.json] [--cjk-font file.ttf]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Logger::setLogLevel(LogLevel::ERROR);
+
+    vg    = createContext(&stash);
+    style = Style::horizon();
+
+    std::vector<Benchmark> benchmarks;
+    addAnimationBenchmarks(&benchmarks);
+    addEventBenchmarks(&benchmarks);
+    addLayoutBenchmarks(&benchmarks);
+    addGlyphBenchmarks(&benchmarks);
+    addActionsBenchmarks(&benchmarks);
+    addTessellationBenchmarks(&benchmarks);
+
+    std::vector<BenchmarkResult> results;
+
+    fprintf(stderr, "%-36s %12s %12s %12s %12s\n", "benchmark", "iterations", "median", "mean", "ci95");
+
+    for (Benchmark& benchmark : benchmarks)
+    {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos)
+            continue;
+
+        BenchmarkResult result = runBenchmark(&benchmark, samples);
+
+        fprintf(stderr, "%-36s %12llu %9.1f ns %9.1f ns %9.1f ns\n",
+            result.name.c_str(),
+            (unsigned long long)result.iterations,
+            result.median,
+            result.mean,
+            result.ci95);
+
+        results.push_back(result);
+    }
+
+    if (results.empty())
+    {
+        fprintf(stderr, "No benchmark matches \"%s\"\n", filter.c_str());
+        return 1;
+    }
+
+    FILE* file = output ? fopen(output, "w") : stdout;
+
+    if (!file)
+    {
+        fprintf(stderr, "Cannot open %s\n", output);
+        return 1;
+    }
+
+    writeResults(file, results, samples);
+
+    if (output)
+        fclose(file);
+
+    destroyContext(vg);
+
+    return 0;
+}
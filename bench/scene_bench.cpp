@@ -0,0 +1,417 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+// Scene benchmarks: stress scenes run headless for a fixed number
+// of frames under the virtual clock, with scripted navigation
+//
+// Usage: borealis_bench [--scene name] [--count n] [--frames n] [--output file.json]
+//
+// The results are written as JSON, one entry per scene:
+// wall times of every phase, layouts, nanovg draw calls and
+// GL draw calls left after batching (BOREALIS_GL_BATCHING=0 to compare)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <borealis.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define FRAME_STEP (1000.0f / 60.0f) // ms
+#define DEFAULT_FRAMES 600
+#define TEARDOWN_FRAMES 60
+
+using namespace brls;
+
+// Scripted inputs, relative to the first frame of the scene
+struct ScriptStep
+{
+    unsigned frame;
+    int button;
+    bool pressed;
+};
+
+struct Scene
+{
+    std::string name;
+    unsigned defaultCount;
+    std::function<View*(unsigned count)> build;
+    std::vector<ScriptStep> script;
+    std::function<void(unsigned frame)> onFrame; // optional
+};
+
+struct SceneResult
+{
+    std::string name;
+    unsigned count;
+    unsigned frames;
+
+    double buildMs;
+    double firstFrameMs;
+    std::vector<double> frameMs;
+    double teardownMs;
+
+    uint64_t layouts;
+    uint64_t drawCalls;
+    uint64_t glDrawCalls;
+    uint64_t focusLookups;
+};
+
+static double elapsedMs(retro_time_t start)
+{
+    return (cpu_features_get_time_usec() - start) / 1000.0;
+}
+
+// Holds the button for the given number of frames, starting at the given frame
+static void hold(std::vector<ScriptStep>* script, unsigned frame, int button, unsigned frames)
+{
+    script->push_back({ frame, button, true });
+    script->push_back({ frame + frames, button, false });
+}
+
+// Presses the button count times, every interval frames
+static void tap(std::vector<ScriptStep>* script, unsigned frame, int button, unsigned count, unsigned interval)
+{
+    for (unsigned i = 0; i < count; i++)
+        hold(script, frame + i * interval, button, 1);
+}
+
+static std::vector<ScriptStep> scrollScript()
+{
+    std::vector<ScriptStep> script;
+    hold(&script, 30, GLFW_GAMEPAD_BUTTON_DPAD_DOWN, 180); // fast scroll with key repeat
+    tap(&script, 240, GLFW_GAMEPAD_BUTTON_DPAD_UP, 20, 6);
+    tap(&script, 380, GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER, 4, 15); // page down
+    hold(&script, 460, GLFW_GAMEPAD_BUTTON_DPAD_UP, 120);
+    std::sort(script.begin(), script.end(), [](const ScriptStep& a, const ScriptStep& b) { return a.frame < b.frame; });
+    return script;
+}
+
+static View* buildList(unsigned count, bool rich)
+{
+    List* list = new List();
+    list->reserve(count);
+    list->setBuilderMode(true);
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        std::string label = "Item " + std::to_string(i);
+
+        ListItem* item;
+        if (rich)
+        {
+            item = new ListItem(label, "A description long enough to need a few lines of text: the quick brown fox jumps over the lazy dog", "Sub label");
+            item->setThumbnail(BOREALIS_ASSET("icon/borealis.jpg"));
+        }
+        else
+        {
+            item = new ListItem(label);
+        }
+
+        list->addView(item);
+    }
+
+    return list;
+}
+
+static View* buildTable(unsigned count)
+{
+    List* list   = new List();
+    Table* table = new Table();
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        if (i % 50 == 0)
+            table->addRow(TableRowType::HEADER, "Section " + std::to_string(i / 50));
+        else
+            table->addRow(TableRowType::BODY, "Row " + std::to_string(i), std::to_string(i * 1024) + " KB");
+    }
+
+    list->addView(new ListItem("Before the table"));
+    list->addView(table);
+    list->addView(new ListItem("After the table"));
+
+    return list;
+}
+
+static View* buildNestedBoxes(unsigned depth)
+{
+    View* content = new ListItem("Innermost item");
+
+    for (unsigned i = 0; i < depth; i++)
+    {
+        BoxLayout* box = new BoxLayout(i % 2 == 0 ? BoxLayoutOrientation::VERTICAL : BoxLayoutOrientation::HORIZONTAL);
+        box->setSpacing(2);
+        box->setMargins(1, 1, 1, 1);
+
+        Rectangle* rectangle = new Rectangle(nvgRGB(40 + i % 200, 80, 120));
+        rectangle->setWidth(4);
+        rectangle->setHeight(4);
+
+        box->addView(rectangle);
+        box->addView(content, true);
+
+        content = box;
+    }
+
+    return content;
+}
+
+static View* buildTabs(unsigned count)
+{
+    TabFrame* frame = new TabFrame();
+    frame->setTitle("Tabs benchmark");
+
+    for (unsigned i = 0; i < count; i++)
+        frame->addTab("Tab " + std::to_string(i), buildList(50, false));
+
+    return frame;
+}
+
+static std::vector<Scene> getScenes()
+{
+    std::vector<Scene> scenes;
+
+    scenes.push_back({ "list", 1000, [](unsigned count) { return buildList(count, false); }, scrollScript(), nullptr });
+    scenes.push_back({ "list_rich", 200, [](unsigned count) { return buildList(count, true); }, scrollScript(), nullptr });
+    scenes.push_back({ "table", 1000, buildTable, scrollScript(), nullptr });
+
+    std::vector<ScriptStep> boxesScript;
+    tap(&boxesScript, 30, GLFW_GAMEPAD_BUTTON_DPAD_DOWN, 10, 20);
+    scenes.push_back({ "nested_boxes", 64, buildNestedBoxes, boxesScript, nullptr });
+
+    scenes.push_back({ "notifications", 8, [](unsigned count) { return buildList(20, false); }, {},
+        [](unsigned frame) {
+            // A burst every second, more than there are slots
+            if (frame % 60 == 0)
+            {
+                for (unsigned i = 0; i < BRLS_NOTIFICATIONS_MAX + 4; i++)
+                    Application::notify("Notification " + std::to_string(frame / 60) + "." + std::to_string(i));
+            }
+        } });
+
+    std::vector<ScriptStep> tabsScript;
+    tap(&tabsScript, 30, GLFW_GAMEPAD_BUTTON_DPAD_LEFT, 1, 1); // to the sidebar
+    tap(&tabsScript, 60, GLFW_GAMEPAD_BUTTON_DPAD_DOWN, 15, 12);
+    tap(&tabsScript, 300, GLFW_GAMEPAD_BUTTON_DPAD_UP, 15, 8);
+    hold(&tabsScript, 450, GLFW_GAMEPAD_BUTTON_DPAD_DOWN, 100);
+    scenes.push_back({ "tab_switch", 16, buildTabs, tabsScript, nullptr });
+
+    return scenes;
+}
+
+static bool runFrame()
+{
+    return Application::mainLoop();
+}
+
+static SceneResult runScene(Scene* scene, unsigned count, unsigned frames)
+{
+    SceneResult result;
+    result.name   = scene->name;
+    result.count  = count;
+    result.frames = frames;
+
+    // Build
+    retro_time_t start = cpu_features_get_time_usec();
+    View* view         = scene->build(count);
+    result.buildMs     = elapsedMs(start);
+
+    // Push and first frame (full layout)
+    start = cpu_features_get_time_usec();
+    Application::pushView(view);
+    runFrame();
+    result.firstFrameMs = elapsedMs(start);
+
+    // Scripted frames
+    FrameStats frameStats = *Application::getFrameStats();
+    FocusStats focusStats = *Application::getFocusStats();
+
+    size_t step = 0;
+    for (unsigned frame = 0; frame < frames; frame++)
+    {
+        for (; step < scene->script.size() && scene->script[step].frame == frame; step++)
+        {
+            ScriptStep* s = &scene->script[step];
+            Application::getInputManager()->pushEvent({ s->button, s->pressed, Clock::getTimeUsec() });
+        }
+
+        start = cpu_features_get_time_usec();
+
+        if (scene->onFrame)
+            scene->onFrame(frame);
+
+        if (!runFrame())
+            break;
+
+        result.frameMs.push_back(elapsedMs(start));
+    }
+
+    result.layouts      = Application::getFrameStats()->layouts - frameStats.layouts;
+    result.drawCalls    = Application::getFrameStats()->drawCalls - frameStats.drawCalls;
+    result.glDrawCalls  = Application::getFrameStats()->glDrawCalls - frameStats.glDrawCalls;
+    result.focusLookups = Application::getFocusStats()->totalLookups - focusStats.totalLookups;
+
+    // Release anything still held
+    for (int button = 0; button <= GLFW_GAMEPAD_BUTTON_LAST; button++)
+        Application::getInputManager()->pushEvent({ button, false, Clock::getTimeUsec() });
+
+    // Pop and let the hide animation free the scene
+    start = cpu_features_get_time_usec();
+    Application::popView();
+
+    for (unsigned i = 0; i < TEARDOWN_FRAMES; i++)
+        runFrame();
+
+    result.teardownMs = elapsedMs(start);
+
+    return result;
+}
+
+static void writeStats(FILE* file, std::vector<double> values)
+{
+    if (values.empty())
+    {
+        fprintf(file, "null");
+        return;
+    }
+
+    std::sort(values.begin(), values.end());
+
+    double sum = 0.0;
+    for (double value : values)
+        sum += value;
+
+    fprintf(file, "{ \"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f }",
+        sum / values.size(),
+        values[values.size() / 2],
+        values[values.size() * 90 / 100],
+        values[values.size() * 99 / 100],
+        values.back());
+}
+
+static void writeResults(FILE* file, std::vector<SceneResult>& results)
+{
+    fprintf(file, "{\n  \"frame_step_ms\": %.4f,\n  \"scenes\": [\n", FRAME_STEP);
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        SceneResult* result = &results[i];
+        unsigned frames     = std::max((size_t)1, result->frameMs.size());
+
+        fprintf(file, "    {\n");
+        fprintf(file, "      \"name\": \"%s\",\n", result->name.c_str());
+        fprintf(file, "      \"count\": %u,\n", result->count);
+        fprintf(file, "      \"frames\": %zu,\n", result->frameMs.size());
+        fprintf(file, "      \"build_ms\": %.4f,\n", result->buildMs);
+        fprintf(file, "      \"first_frame_ms\": %.4f,\n", result->firstFrameMs);
+        fprintf(file, "      \"frame_ms\": ");
+        writeStats(file, result->frameMs);
+        fprintf(file, ",\n");
+        fprintf(file, "      \"teardown_ms\": %.4f,\n", result->teardownMs);
+        fprintf(file, "      \"layouts\": %llu,\n", (unsigned long long)result->layouts);
+        fprintf(file, "      \"draw_calls\": %llu,\n", (unsigned long long)result->drawCalls);
+        fprintf(file, "      \"draw_calls_per_frame\": %.2f,\n", (double)result->drawCalls / frames);
+        fprintf(file, "      \"gl_draw_calls\": %llu,\n", (unsigned long long)result->glDrawCalls);
+        fprintf(file, "      \"gl_draw_calls_per_frame\": %.2f,\n", (double)result->glDrawCalls / frames);
+        fprintf(file, "      \"focus_lookups\": %llu\n", (unsigned long long)result->focusLookups);
+        fprintf(file, "    }%s\n", i + 1 < results.size() ? "," : "");
+    }
+
+    fprintf(file, "  ]\n}\n");
+}
+
+int main(int argc, char* argv[])
+{
+    std::string onlyScene;
+    unsigned count     = 0;
+    unsigned frames    = DEFAULT_FRAMES;
+    const char* output = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc)
+            onlyScene = argv[++i];
+        else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else
+        {
+            fprintf(stderr, "Usage: %s [--scene name] [--count n] [--frames n] [--output file.json]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Keep stdout for the results
+    Logger::setLogLevel(LogLevel::ERROR);
+
+    Clock::setVirtual(FRAME_STEP);
+    Application::setHeadless(true);
+
+    if (!Application::init("Borealis benchmark"))
+    {
+        Logger::error("Unable to init Borealis application");
+        return EXIT_FAILURE;
+    }
+
+    // Scenes are pushed on top of an empty root view, which is never popped
+    Application::pushView(new Rectangle(nvgRGB(0, 0, 0)));
+    runFrame();
+
+    std::vector<Scene> scenes = getScenes();
+    std::vector<SceneResult> results;
+
+    for (Scene& scene : scenes)
+    {
+        if (!onlyScene.empty() && scene.name != onlyScene)
+            continue;
+
+        fprintf(stderr, "Running %s...\n", scene.name.c_str());
+        results.push_back(runScene(&scene, count ? count : scene.defaultCount, frames));
+    }
+
+    if (results.empty())
+    {
+        fprintf(stderr, "Unknown scene \"%s\"\n", onlyScene.c_str());
+        return EXIT_FAILURE;
+    }
+
+    FILE* file = output ? fopen(output, "w") : stdout;
+    if (!file)
+    {
+        fprintf(stderr, "Cannot open %s\n", output);
+        return EXIT_FAILURE;
+    }
+
+    writeResults(file, results);
+
+    if (output)
+        fclose(file);
+
+    Application::quit();
+    Application::mainLoop();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,220 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+// Throughput and latency benchmark of brls::ThreadPool
+// Usage: borealis_thread_pool_bench [threads count]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <borealis/thread_pool.hpp>
+#include <chrono>
+#include <vector>
+
+using namespace brls;
+using Clock = std::chrono::steady_clock;
+
+static double elapsedUs(Clock::time_point start, Clock::time_point end)
+{
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+static void printLatencies(const char* name, std::vector<double>& samples)
+{
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+    for (double sample : samples)
+        sum += sample;
+
+    printf("%-28s mean %9.2f us   p50 %9.2f us   p99 %9.2f us   max %9.2f us\n",
+        name,
+        sum / samples.size(),
+        samples[samples.size() / 2],
+        samples[samples.size() * 99 / 100],
+        samples.back());
+}
+
+// Many tiny tasks submitted from the main thread
+static void benchThroughput(ThreadPool* pool, size_t count)
+{
+    std::atomic<size_t> done(0);
+
+    Clock::time_point start = Clock::now();
+
+    for (size_t i = 0; i < count; i++)
+        pool->submit([&done] { done++; });
+
+    while (done < count)
+        std::this_thread::yield();
+
+    double us = elapsedUs(start, Clock::now());
+    printf("%-28s %zu tasks in %.2f ms (%.0f tasks/s)\n", "throughput (external)", count, us / 1000.0, count / (us / 1000000.0));
+}
+
+// One task spawning all the others, the other workers have to steal them
+static void benchStealing(ThreadPool* pool, size_t count)
+{
+    std::atomic<size_t> done(0);
+
+    Clock::time_point start = Clock::now();
+
+    pool->submit([pool, count, &done] {
+        for (size_t i = 0; i < count; i++)
+            pool->submit([&done] {
+                // Some work so that stealing pays off
+                volatile unsigned value = 0;
+                for (unsigned j = 0; j < 2000; j++)
+                    value += j;
+                done++;
+            });
+    });
+
+    while (done < count)
+        std::this_thread::yield();
+
+    double us = elapsedUs(start, Clock::now());
+    printf("%-28s %zu tasks in %.2f ms (%.0f tasks/s)\n", "throughput (nested)", count, us / 1000.0, count / (us / 1000000.0));
+}
+
+// Time between submit() and the start of the work, on an idle pool
+static void benchStartLatency(ThreadPool* pool, size_t count)
+{
+    std::vector<double> samples;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        Clock::time_point started;
+        Clock::time_point submitted = Clock::now();
+
+        TaskHandle handle = pool->submit([&started] { started = Clock::now(); });
+        handle.wait();
+
+        samples.push_back(elapsedUs(submitted, started));
+    }
+
+    printLatencies("start latency (idle)", samples);
+}
+
+// High priority tasks submitted behind a backlog of low priority ones
+static void benchPriority(ThreadPool* pool, size_t backlog, size_t count)
+{
+    std::atomic<size_t> done(0);
+    std::vector<double> samples;
+
+    for (size_t i = 0; i < backlog; i++)
+    {
+        pool->submit(
+            [&done] {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+                done++;
+            },
+            nullptr, TaskPriority::LOW);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        Clock::time_point started;
+        Clock::time_point submitted = Clock::now();
+
+        TaskHandle handle = pool->submit([&started] { started = Clock::now(); }, nullptr, TaskPriority::HIGH);
+        handle.wait();
+
+        samples.push_back(elapsedUs(submitted, started));
+    }
+
+    printLatencies("start latency (high prio)", samples);
+
+    while (done < backlog)
+        std::this_thread::yield();
+}
+
+// Time between the end of the work and its completion on a simulated 60 FPS UI thread
+static void benchCompletionLatency(ThreadPool* pool, size_t count)
+{
+    std::vector<double> samples;
+    std::vector<Clock::time_point> finished(count);
+    size_t completed = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        pool->submit([&finished, i] { finished[i] = Clock::now(); },
+            [&samples, &finished, &completed, i] {
+                samples.push_back(elapsedUs(finished[i], Clock::now()));
+                completed++;
+            });
+    }
+
+    while (completed < count)
+    {
+        pool->dispatchCompletions();
+        std::this_thread::sleep_for(std::chrono::microseconds(16666));
+    }
+
+    printLatencies("completion latency (60 FPS)", samples);
+}
+
+// Cancelling pending tasks
+static void benchCancellation(ThreadPool* pool, size_t count)
+{
+    std::atomic<size_t> ran(0);
+    std::vector<TaskHandle> handles;
+
+    // Keep the workers busy so that the tasks stay pending
+    std::atomic<bool> release(false);
+    std::vector<TaskHandle> blockers;
+    for (unsigned i = 0; i < pool->getThreadsCount(); i++)
+        blockers.push_back(pool->submit([&release] { while (!release) std::this_thread::yield(); }, nullptr, TaskPriority::HIGH));
+
+    for (size_t i = 0; i < count; i++)
+        handles.push_back(pool->submit([&ran] { ran++; }));
+
+    size_t cancelled = 0;
+    for (TaskHandle& handle : handles)
+        if (handle.cancel())
+            cancelled++;
+
+    release = true;
+
+    for (TaskHandle& handle : handles)
+        handle.wait();
+    for (TaskHandle& handle : blockers)
+        handle.wait();
+
+    printf("%-28s %zu / %zu cancelled before starting, %zu ran\n", "cancellation", cancelled, count, ran.load());
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned threads = argc > 1 ? atoi(argv[1]) : 0;
+
+    ThreadPool pool(threads);
+    printf("Thread pool with %u workers\n\n", pool.getThreadsCount());
+
+    benchThroughput(&pool, 200000);
+    benchStealing(&pool, 20000);
+    benchStartLatency(&pool, 2000);
+    benchPriority(&pool, 2000, 200);
+    benchCompletionLatency(&pool, 60);
+    benchCancellation(&pool, 10000);
+
+    return EXIT_SUCCESS;
+}
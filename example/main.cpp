@@ -100,6 +100,11 @@ int main(int argc, char* argv[])
 
     brls::ListItem* installerItem = new brls::ListItem("Open example installer");
     installerItem->getClickEvent()->subscribe([](brls::View* view) {
+        // All views of the installer are allocated from an arena,
+        // freed in one go when the installer is popped
+        brls::ViewArena* arena = new brls::ViewArena();
+        brls::ViewArenaScope arenaScope(arena);
+
         brls::StagedAppletFrame* stagedFrame = new brls::StagedAppletFrame();
         stagedFrame->setTitle("My great installer");
 
@@ -108,6 +113,9 @@ int main(int argc, char* argv[])
         stagedFrame->addStage(new SampleInstallerPage(stagedFrame, "Finish"));
 
         brls::Application::pushView(stagedFrame);
+
+        // The application now holds its own reference
+        arena->release();
     });
 
     brls::SelectListItem* layerSelectItem = new brls::SelectListItem("Select Layer", { "Layer 1", "Layer 2" });
@@ -153,8 +161,18 @@ int main(int argc, char* argv[])
 
     testList->addView(layerSelectItem);
 
+    brls::ScrollView* gridScrollView = new brls::ScrollView();
+    brls::GridView* grid             = new brls::GridView(200, 100);
+    grid->setSpacing(20);
+    grid->setDataSource(
+        10000,
+        []() { return new brls::Button(brls::ButtonStyle::BORDERED); },
+        [](brls::View* cell, size_t index) { ((brls::Button*)cell)->setLabel("Tile " + std::to_string(index + 1)); });
+    gridScrollView->setContentView(grid);
+
     rootFrame->addTab("First tab", testList);
     rootFrame->addTab("Second tab", testLayers);
+    rootFrame->addTab("Grid", gridScrollView);
     rootFrame->addSeparator();
     rootFrame->addTab("Third tab", new brls::Rectangle(nvgRGB(255, 0, 0)));
     rootFrame->addTab("Fourth tab", new brls::Rectangle(nvgRGB(0, 255, 0)));
@@ -22,13 +22,23 @@
 
 #include <math.h>
 
+#include <chrono>
+#include <thread>
+
+#define COPY_SIZE (512ull * 1024 * 1024)
+#define COPY_CHUNK (1024 * 1024)
+
 SampleLoadingPage::SampleLoadingPage(brls::StagedAppletFrame* frame)
     : frame(frame)
 {
-    // Label
-    this->progressDisp = new brls::ProgressDisplay();
-    this->progressDisp->setProgress(this->progressValue, 1000);
+    // Progress, fed by the copy thread
+    this->progress.setTotal(COPY_SIZE);
+
+    this->progressDisp = new brls::ProgressDisplay((brls::ProgressDisplayFlags)(brls::DEFAULT_PROGRESS_DISPLAY_FLAGS | brls::ProgressDisplayFlags::THROUGHPUT | brls::ProgressDisplayFlags::ETA));
+    this->progressDisp->setSource(&this->progress);
     this->progressDisp->setParent(this);
+
+    // Label
     this->label = new brls::Label(brls::LabelStyle::DIALOG, "Example loading display", true);
     this->label->setHorizontalAlign(NVG_ALIGN_CENTER);
     this->label->setParent(this);
@@ -36,11 +46,6 @@ SampleLoadingPage::SampleLoadingPage(brls::StagedAppletFrame* frame)
 
 void SampleLoadingPage::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, brls::Style* style, brls::FrameContext* ctx)
 {
-    if (progressValue == 500)
-        this->frame->nextStage();
-
-    this->progressValue++;
-    this->progressDisp->setProgress(this->progressValue, 500);
     this->progressDisp->frame(ctx);
     this->label->frame(ctx);
 }
@@ -60,12 +65,34 @@ void SampleLoadingPage::layout(NVGcontext* vg, brls::Style* style, brls::FontSta
         this->x + this->width / 2 - style->CrashFrame.buttonWidth,
         this->y + this->height / 2,
         style->CrashFrame.buttonWidth * 2,
-        style->CrashFrame.buttonHeight);
+        style->CrashFrame.buttonHeight * 2);
 }
 
 void SampleLoadingPage::willAppear(bool resetState)
 {
     this->progressDisp->willAppear(resetState);
+
+    if (this->copyTask.isValid())
+        return;
+
+    // Pretend to copy a big file in the background
+    brls::StagedAppletFrame* frame = this->frame;
+    brls::ProgressSource* progress = &this->progress;
+
+    this->copyTask = brls::Application::getThreadPool()->submit(
+        [progress]() {
+            for (uint64_t copied = 0; copied < COPY_SIZE; copied += COPY_CHUNK)
+            {
+                if (brls::ThreadPool::isCurrentTaskCancelled())
+                    return;
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(15));
+                progress->advance(COPY_CHUNK);
+            }
+        },
+        [frame]() {
+            frame->nextStage();
+        });
 }
 
 void SampleLoadingPage::willDisappear(bool resetState)
@@ -75,6 +102,10 @@ void SampleLoadingPage::willDisappear(bool resetState)
 
 SampleLoadingPage::~SampleLoadingPage()
 {
+    // The copy thread uses the progress source
+    this->copyTask.cancel();
+    this->copyTask.wait();
+
     delete this->progressDisp;
     delete this->label;
 }
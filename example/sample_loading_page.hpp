@@ -28,7 +28,9 @@ class SampleLoadingPage : public brls::View
     brls::StagedAppletFrame* frame;
     brls::ProgressDisplay* progressDisp;
     brls::Label* label;
-    int progressValue = 0;
+
+    brls::ProgressSource progress;
+    brls::TaskHandle copyTask;
 
   public:
     SampleLoadingPage(brls::StagedAppletFrame* frame);
@@ -29,19 +29,27 @@
 #include <borealis/application.hpp>
 #include <borealis/box_layout.hpp>
 #include <borealis/button.hpp>
+#include <borealis/clock.hpp>
 #include <borealis/crash_frame.hpp>
 #include <borealis/dialog.hpp>
 #include <borealis/dropdown.hpp>
 #include <borealis/event.hpp>
+#include <borealis/flight_recorder.hpp>
+#include <borealis/gl_audit.hpp>
+#include <borealis/grid_view.hpp>
 #include <borealis/header.hpp>
 #include <borealis/image.hpp>
+#include <borealis/input_manager.hpp>
+#include <borealis/input_recorder.hpp>
 #include <borealis/label.hpp>
 #include <borealis/layer_view.hpp>
 #include <borealis/list.hpp>
 #include <borealis/logger.hpp>
+#include <borealis/main_thread_queue.hpp>
 #include <borealis/material_icon.hpp>
 #include <borealis/notification_manager.hpp>
 #include <borealis/popup_frame.hpp>
+#include <borealis/profiler.hpp>
 #include <borealis/progress_display.hpp>
 #include <borealis/progress_spinner.hpp>
 #include <borealis/rectangle.hpp>
@@ -52,5 +60,8 @@
 #include <borealis/tab_frame.hpp>
 #include <borealis/table.hpp>
 #include <borealis/theme.hpp>
+#include <borealis/thread_pool.hpp>
 #include <borealis/thumbnail_frame.hpp>
+#include <borealis/timer_scheduler.hpp>
 #include <borealis/view.hpp>
+#include <borealis/view_arena.hpp>
@@ -18,8 +18,11 @@
 
 #pragma once
 
+#include <array>
+#include <bitset>
 #include <functional>
 #include <string>
+#include <vector>
 
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
@@ -65,4 +68,75 @@ struct Action
     }
 };
 
+#define BRLS_KEYS_COUNT (GLFW_GAMEPAD_BUTTON_LAST + 1)
+
+typedef std::bitset<BRLS_KEYS_COUNT> KeySet;
+
+// An action registered on a view, by index
+// in the view actions (actions are never removed)
+struct ActionRef
+{
+    View* view;
+    size_t index;
+
+    const Action& get() const;
+};
+
+// All the actions of a focus path (from the focused view
+// up to the root), indexed by key
+// Built by Application when the focus path or its actions change
+class ActionTable
+{
+  private:
+    std::vector<View*> focusPath;
+
+    std::vector<ActionRef> actions; // all actions, in focus path order
+    std::vector<ActionRef> actionsByKey; // the same actions, grouped by key
+    std::array<size_t, BRLS_KEYS_COUNT + 1> keysOffsets; // range of each key in actionsByKey
+
+    KeySet availableKeys; // keys with at least one available action
+
+    bool flagsFocusPath; // maintains View::isOnFocusPath()
+
+  public:
+    /**
+     * Only the application table flags the views of its focus path, as
+     * it's the one told about destroyed views: other tables must not
+     * outlive the views they were built for
+     */
+    ActionTable(bool flagsFocusPath = false);
+
+    /**
+     * Rebuilds the table for the given focused view
+     */
+    void build(View* focus);
+
+    /**
+     * Returns the actions registered for the given key,
+     * from the focused view up to the root
+     */
+    const ActionRef* getActions(Key key, size_t* count);
+
+    /**
+     * Returns all actions, from the focused view up to the root,
+     * in registration order for every view
+     */
+    const std::vector<ActionRef>& getActions();
+
+    bool hasAvailableAction(Key key);
+
+    /**
+     * Returns the focus path, from the focused view up to the root
+     */
+    const std::vector<View*>& getFocusPath();
+
+    bool isOnFocusPath(View* view);
+
+    /**
+     * Removes a view from the focus path, before it's destroyed
+     * or moved - the table must be rebuilt afterwards
+     */
+    void remove(View* view);
+};
+
 } // namespace brls
@@ -127,22 +127,17 @@ typedef struct menu_animation_ctx_ticker
     const char* spacer;
 } menu_animation_ctx_ticker_t;
 
-typedef float menu_timer_t;
+// Id of the scheduled timer, 0 if none - timers are
+// run by the task manager TimerScheduler, not as tweens
+typedef uint64_t menu_timer_t;
 
 typedef struct menu_timer_ctx_entry
 {
     float duration;
     tween_cb cb;
-    tween_cb tick;
     void* userdata;
 } menu_timer_ctx_entry_t;
 
-typedef struct menu_delayed_animation
-{
-    menu_timer_t timer;
-    menu_animation_ctx_entry_t entry;
-} menu_delayed_animation_t;
-
 void menu_timer_start(menu_timer_t* timer, menu_timer_ctx_entry_t* timer_entry);
 
 void menu_timer_kill(menu_timer_t* timer);
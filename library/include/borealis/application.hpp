@@ -24,21 +24,47 @@
 #include <nanovg.h>
 
 #include <borealis/animations.hpp>
+#include <borealis/flight_recorder.hpp>
 #include <borealis/frame_context.hpp>
 #include <borealis/hint.hpp>
+#include <borealis/input_manager.hpp>
+#include <borealis/input_recorder.hpp>
 #include <borealis/label.hpp>
 #include <borealis/logger.hpp>
+#include <borealis/main_thread_queue.hpp>
 #include <borealis/notification_manager.hpp>
+#include <borealis/profiler.hpp>
 #include <borealis/style.hpp>
 #include <borealis/task_manager.hpp>
 #include <borealis/theme.hpp>
+#include <borealis/thread_pool.hpp>
 #include <borealis/view.hpp>
 #include <map>
+#include <thread>
 #include <vector>
 
 namespace brls
 {
 
+// Counters of the views visited while looking
+// for the next view to focus
+struct FocusStats
+{
+    unsigned lastLookups  = 0; // during the last navigation
+    unsigned maxLookups   = 0;
+    uint64_t totalLookups = 0;
+    uint64_t navigations  = 0;
+};
+
+// Counters of the work done by the frames
+struct FrameStats
+{
+    uint64_t frames      = 0;
+    uint64_t layouts     = 0; // views laid out
+    uint64_t drawCalls   = 0; // as counted by nanovg
+    uint64_t glDrawCalls = 0; // issued by the GL backend, after batching
+};
+
 // The top-right framerate counter
 class FramerateCounter : public Label
 {
@@ -70,6 +96,10 @@ class Application
       * the whole screen and layout() will be called
       *
       * The view will gain focus if applicable
+      *
+      * If the view was allocated from a ViewArena, the application
+      * takes a reference on the arena and releases it when popping
+      * the view - the creator still has to release its own
       */
     static void pushView(View* view, ViewAnimation animation = ViewAnimation::FADE);
 
@@ -100,6 +130,37 @@ class Application
 
     static void notify(std::string text);
 
+    /**
+     * Runs the function on the main thread, at the end of the
+     * current or next frame - the only sanctioned way for other
+     * threads to touch the UI
+     *
+     * Can be called from any thread
+     */
+    static void runOnMainThread(std::function<void(void)> func);
+
+    /**
+     * Same as above, but only the last function posted with a given
+     * key is run if several are waiting (for instance, use
+     * the updated view as a key when posting its new state)
+     */
+    static void runOnMainThread(const void* key, std::function<void(void)> func);
+
+    /**
+     * Sets the time the main thread can spend running posted functions
+     * every frame, in microseconds (default: 2000) - at least one
+     * runs every frame, the others wait for the next one
+     */
+    static void setMainThreadBudget(retro_time_t budget);
+
+    static bool isMainThread();
+
+    /**
+     * Aborts if called outside of the main thread, use through
+     * BRLS_ASSERT_MAIN_THREAD()
+     */
+    static void assertMainThread(const char* function);
+
     static void onGamepadButtonPressed(char button, bool repeating);
 
     /**
@@ -122,6 +183,8 @@ class Application
 
     static NVGcontext* getNVGContext();
     static TaskManager* getTaskManager();
+    static ThreadPool* getThreadPool();
+    static InputManager* getInputManager();
     static NotificationManager* getNotificationManager();
 
     static void setCommonFooter(std::string footer);
@@ -132,6 +195,36 @@ class Application
 
     static void setMaximumFPS(unsigned fps);
 
+    /**
+     * Enables or disables vsync - always disabled in headless mode
+     */
+    static void setVSync(bool enabled);
+
+    /**
+     * When enabled, the frame limiter keeps sleeping while nothing
+     * is animated and no button is held, until the next timer
+     * is due or an input comes in (and at most 250ms)
+     *
+     * Saves power on static screens, at the cost of freezing
+     * the highlight pulse - needs a maximum FPS, disabled by default
+     */
+    static void setIdleSleep(bool enabled);
+
+    /**
+     * Sets how often gamepads are sampled while waiting for the next
+     * frame, in usec (4ms by default, at least 16ms while idle)
+     *
+     * Keyboard and window events wake the wait up on their own,
+     * 0 only samples once per frame and saves the most CPU
+     */
+    static void setInputSamplingPeriod(unsigned usec);
+
+    /**
+     * Sets the timing of the key repeat
+     */
+    static void setKeyRepeatCurve(KeyRepeatCurve curve);
+    static KeyRepeatCurve* getKeyRepeatCurve();
+
     // public so that the glfw callback can access it
     inline static unsigned contentWidth, contentHeight;
     inline static float windowScale;
@@ -139,21 +232,87 @@ class Application
     static void resizeFramerateCounter();
     static void resizeNotificationManager();
 
+    /**
+     * Called by the framebuffer size callback, the views are
+     * notified at the beginning of the next frame
+     */
+    static void setWindowSize(unsigned width, unsigned height);
+
     static GenericEvent* getGlobalFocusChangeEvent();
     static VoidEvent* getGlobalHintsUpdateEvent();
 
     static View* getCurrentFocus();
 
+    /**
+     * Called by layouts for every child they ask
+     * for focus while navigating
+     */
+    static void countFocusLookup();
+    static FocusStats* getFocusStats();
+
+    static void countLayout();
+    static FrameStats* getFrameStats();
+
+    /**
+     * Creates an invisible window without vsync at init,
+     * for benchmarks - must be called before init()
+     */
+    static void setHeadless(bool headless);
+
+    /**
+     * Records the gamepad state of every frame to the given file,
+     * until exit() or stopRecordingInputs()
+     * Also enabled at init by the BOREALIS_RECORD_INPUT env variable
+     */
+    static bool recordInputs(std::string path);
+    static void stopRecordingInputs();
+
+    /**
+     * Replays the inputs recorded to the given file instead of reading the gamepad,
+     * with the Clock following the recorded timestamps, then quits the app
+     * The frames statistics are written as JSON to reportPath, or next to the recording
+     * Also enabled at init by the BOREALIS_REPLAY_INPUT env variable
+     * (with BOREALIS_REPLAY_REPORT for the report and BOREALIS_HEADLESS=1 to replay headless)
+     */
+    static bool replayInputs(std::string path, std::string reportPath = "");
+    static bool isReplayingInputs();
+
+    /**
+     * Injects a virtual gamepad button press or release, processed
+     * at the start of the next frame like a physical one (key repeat included)
+     * timestamp is the Clock time of the event, or now if negative
+     * Can be called from any thread
+     */
+    static void injectButton(int button, bool pressed, retro_time_t timestamp = -1);
+
+    /**
+     * Returns the actions table of the current focus path,
+     * rebuilding it if needed
+     */
+    static ActionTable* getActionTable();
+
+    /**
+     * Invalidates the actions table if the given view
+     * is on the current focus path
+     * Called by views when their actions or parent change
+     */
+    static void invalidateActionTable(View* view);
+
     static std::string getTitle();
 
   private:
+    // Times handleAction() without a window
+    friend class MicroBench;
+
     inline static GLFWwindow* window;
     inline static NVGcontext* vg;
 
     inline static std::string title;
 
     inline static TaskManager* taskManager;
+    inline static ThreadPool* threadPool = nullptr;
     inline static NotificationManager* notificationManager;
+    inline static InputManager* inputManager = nullptr;
 
     inline static FontStash fontStash;
 
@@ -161,14 +320,15 @@ class Application
     inline static std::vector<View*> focusStack;
 
     inline static unsigned windowWidth, windowHeight;
+    inline static bool windowSizeChanged = false;
 
     inline static View* currentFocus;
 
     inline static Theme currentTheme;
     inline static ThemeVariant currentThemeVariant;
 
-    inline static GLFWgamepadstate oldGamepad;
-    inline static GLFWgamepadstate gamepad;
+    inline static GLFWgamepadstate gamepad; // state after the last processed input events
+    inline static std::vector<InputEvent> inputEvents;
 
     inline static Style currentStyle;
 
@@ -179,16 +339,72 @@ class Application
     inline static FramerateCounter* framerateCounter = nullptr;
 
     inline static float frameTime = 0.0f;
+    inline static retro_time_t frameStart = 0;
+    inline static bool idleSleep          = false;
+    inline static retro_time_t inputSamplingPeriod = 4000; // usec
+    inline static retro_time_t lastFrameBegin = 0;
+
+    inline static std::thread::id mainThreadId;
+    inline static MainThreadQueue mainThreadQueue;
+    inline static retro_time_t mainThreadBudget = 2000;
 
     inline static View* repetitionOldFocus = nullptr;
 
+    inline static FocusStats focusStats;
+    inline static FrameStats frameStats;
+    inline static bool headless = false;
+    inline static bool vsync    = true;
+
+    inline static InputRecorder inputRecorder;
+    inline static InputReplayer inputReplayer;
+    inline static std::string replayReportPath;
+
+    static void finishReplay();
+
+    inline static KeyRepeatCurve keyRepeatCurve;
+    inline static int repeatingButton          = -1; // last pressed button, while held
+    inline static retro_time_t repeatStartTime = 0; // time of its first repeat
+    inline static retro_time_t nextRepeatTime  = 0;
+
+    inline static ActionTable actionTable = ActionTable(true);
+    inline static bool actionTableDirty = true;
+    inline static unsigned actionTableVersion = 0; // incremented on every rebuild
+
     inline static GenericEvent globalFocusChangeEvent;
     inline static VoidEvent globalHintsUpdateEvent;
 
     static void navigate(FocusDirection direction);
 
+    /**
+     * Moves the focus by one page (L / R), using
+     * the first parent able to do so
+     */
+    static void navigatePage(FocusDirection direction);
+
+    static void beginFocusLookups();
+    static void endFocusLookups();
+
     static void onWindowSizeChanged();
 
+    /**
+     * Sleeps until the next frame is due according to
+     * the maximum FPS, sampling inputs while waiting
+     */
+    static void waitForNextFrame();
+
+    /**
+     * Returns true if the next frames would all look the
+     * same, as long as no timer fires and no input comes in
+     */
+    static bool isIdle();
+
+    static void recordFrameTimings(retro_time_t frameBegin);
+
+    /**
+     * Dispatches queued input events and handles key repeat
+     */
+    static void processInputs();
+
     static void frame();
     static void clear();
     static void exit();
@@ -201,4 +417,11 @@ class Application
     static bool handleAction(char button);
 };
 
+// Catches UI calls made by other threads, in debug builds only
+#ifndef NDEBUG
+#define BRLS_ASSERT_MAIN_THREAD() brls::Application::assertMainThread(__func__)
+#else
+#define BRLS_ASSERT_MAIN_THREAD()
+#endif
+
 } // namespace brls
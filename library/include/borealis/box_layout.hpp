@@ -66,8 +66,17 @@ class BoxLayout : public View
 
     BoxLayoutGravity gravity = BoxLayoutGravity::DEFAULT;
 
+    std::vector<size_t> focusableChildren; // sorted indexes of the children giving focus
+
+    bool builderMode        = false;
+    size_t builderModeStart = 0; // first child added in builder mode
+
+    void updateFocusableChild(size_t index, bool focusable);
+    void appendChild(View* view, bool fill);
+    View* getChildFocus(size_t index);
+
   protected:
-    std::vector<BoxLayoutChild*> children;
+    std::vector<BoxLayoutChild> children;
 
     size_t originalDefaultFocus = 0;
     size_t defaultFocusedIndex  = 0;
@@ -86,16 +95,23 @@ class BoxLayout : public View
       */
     virtual void customSpacing(View* current, View* next, int* spacing) {}
 
+    /**
+      * Returns the first focusable view starting from the
+      * given child index, looking in the given direction first
+      */
+    View* getFocusNearIndex(size_t index, FocusDirection direction);
+
   public:
     BoxLayout(BoxLayoutOrientation orientation, size_t defaultFocus = 0);
     ~BoxLayout();
 
     void layout(NVGcontext* vg, Style* style, FontStash* stash) override;
     void draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx) override;
-    View* getNextFocus(FocusDirection direction, void* parentUserdata) override;
+    View* getNextFocus(FocusDirection direction, View* currentView) override;
     View* getDefaultFocus() override;
     void onChildFocusGained(View* child) override;
     void onChildFocusLost(View* child) override;
+    void onChildFocusabilityChanged(View* child) override;
     void willAppear(bool resetState = false) override;
     void willDisappear(bool resetState = false) override;
     void onWindowSizeChanged() override;
@@ -126,14 +142,30 @@ class BoxLayout : public View
       */
     void addView(View* view, bool fill = false, bool resetState = false);
 
+    /**
+      * Adds multiple views to this box layout, with
+      * one willAppear() sweep and one layout
+      */
+    void addViews(const std::vector<View*>& views, bool fill = false, bool resetState = false);
+
+    /**
+      * Reserves room for the given total count of children
+      */
+    void reserve(size_t count);
+
+    /**
+      * In builder mode, added views don't get willAppear()
+      * and the layout isn't invalidated: this is deferred
+      * until builder mode is disabled or the layout appears,
+      * whichever comes first
+      * Use it to populate big layouts before attaching them
+      */
+    void setBuilderMode(bool builderMode);
+
     /**
       * Removes the view at specified
       * The view will be freed if free
       * is set to true (defaults to true)
-      *
-      * Warning: this method isn't correctly
-      * implemented - currently removing a view will
-      * most likely result in memory corruption
       */
     void removeView(int index, bool free = true);
 
@@ -156,6 +188,19 @@ class BoxLayout : public View
 
     View* getChild(size_t i);
 
+    /**
+      * Gives focus to the child at the given index, or
+      * to the closest focusable one
+      * Returns false if there is no view to focus
+      */
+    bool jumpToIndex(size_t index);
+
+    /**
+      * Returns the view to focus for the given y (vertical) or
+      * x (horizontal) position, based on the last layout
+      */
+    View* getFocusAtPosition(int position, FocusDirection direction);
+
     /**
      * If enabled, will force the layout to resize itself
      * to match the children size
@@ -0,0 +1,93 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <features/features_cpu.h>
+
+#include <atomic>
+
+namespace brls
+{
+
+// The time source used by animations, tasks and frame pacing
+//
+// By default it follows the wall clock. In virtual mode, time
+// only moves forward when the main loop starts a new frame,
+// by exactly the configured step: a given scene then does the
+// same work on every run, regardless of the machine speed
+//
+// The time can be read from any thread (Application::injectButton()),
+// the clock is only configured and advanced by the main thread
+class Clock
+{
+  public:
+    typedef retro_time_t (*TimeSource)(void);
+
+    /**
+     * Returns the current time, in microseconds
+     */
+    static retro_time_t getTimeUsec();
+
+    /**
+     * Returns the current time, in milliseconds
+     */
+    static retro_time_t getTimeMs();
+
+    /**
+     * Sets the function used to read the current time
+     * (in microseconds) - nullptr restores the wall clock
+     * It can be called from any thread
+     *
+     * Ignored while the virtual clock is enabled
+     */
+    static void setTimeSource(TimeSource source);
+
+    /**
+     * Switches to the virtual clock, which advances by
+     * exactly frameStep milliseconds every frame
+     */
+    static void setVirtual(float frameStep);
+
+    /**
+     * Switches back to the real time source
+     */
+    static void setReal();
+
+    static bool isVirtual();
+
+    /**
+     * Returns the virtual clock step, in microseconds
+     */
+    static retro_time_t getFrameStep();
+
+    /**
+     * Called by the main loop when a new frame starts
+     */
+    static void frame();
+
+  private:
+    inline static std::atomic<TimeSource> timeSource = nullptr;
+
+    inline static std::atomic<bool> virtualClock        = false;
+    inline static std::atomic<retro_time_t> virtualTime = 0;
+    inline static retro_time_t frameStep                = 0; // main thread only
+};
+
+} // namespace brls
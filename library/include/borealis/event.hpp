@@ -16,11 +16,16 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+
 #pragma once
 
+#include <assert.h>
+#include <stdint.h>
+
 #include <algorithm>
 #include <functional>
-#include <list>
+#include <iterator>
+#include <vector>
 
 namespace brls
 {
@@ -34,42 +39,205 @@ namespace brls
 // 4. call fire when you want to fire the events
 //    it wil return true if at least one subscriber exists
 //    for that event
+//
+// Callbacks are stored contiguously and are never copied when firing.
+// It is safe to subscribe or unsubscribe from inside a callback:
+// new subscribers will be called starting from the next fire,
+// removed ones will not be called anymore
+//
+// Since callbacks are called in place, an event must not be destroyed
+// from one of its own callbacks (this is asserted in debug builds)
 template <typename... Ts>
 class Event
 {
   public:
     typedef std::function<void(Ts...)> Callback;
-    typedef std::list<Callback> CallbacksList;
-    typedef typename CallbacksList::iterator Subscription;
+    typedef uint64_t Subscription; // 0 is never a valid subscription
+
+    // A subscription that automatically unsubscribes
+    // when destroyed - it must not outlive its event
+    class ScopedSubscription
+    {
+      public:
+        ScopedSubscription() = default;
+
+        ScopedSubscription(Event* event, Subscription subscription)
+            : event(event)
+            , subscription(subscription)
+        {
+        }
+
+        ScopedSubscription(ScopedSubscription&& other)
+            : event(other.event)
+            , subscription(other.subscription)
+        {
+            other.event = nullptr;
+        }
+
+        ScopedSubscription& operator=(ScopedSubscription&& other)
+        {
+            if (this != &other)
+            {
+                this->reset();
+
+                this->event        = other.event;
+                this->subscription = other.subscription;
+                other.event        = nullptr;
+            }
+
+            return *this;
+        }
+
+        ScopedSubscription(const ScopedSubscription&) = delete;
+        ScopedSubscription& operator=(const ScopedSubscription&) = delete;
+
+        /**
+         * Unsubscribes immediately
+         */
+        void reset()
+        {
+            if (this->event)
+                this->event->unsubscribe(this->subscription);
+
+            this->event = nullptr;
+        }
+
+        ~ScopedSubscription()
+        {
+            this->reset();
+        }
+
+      private:
+        Event* event              = nullptr;
+        Subscription subscription = 0;
+    };
+
+    ~Event()
+    {
+        // fire() would resume on freed slots
+        assert(this->firing == 0 && "Event destroyed from one of its callbacks");
+    }
 
     Subscription subscribe(Callback cb);
+    ScopedSubscription subscribeScoped(Callback cb);
     void unsubscribe(Subscription subscription);
     bool fire(Ts... args);
 
   private:
-    CallbacksList callbacks;
+    struct Slot
+    {
+        Subscription subscription;
+        Callback callback;
+        bool removed; // unsubscribed during a fire
+    };
+
+    // Sorted by subscription since subscriptions are increasing
+    std::vector<Slot> slots;
+
+    // Slots subscribed during a fire, merged once it's over
+    std::vector<Slot> pendingSlots;
+
+    Subscription nextSubscription = 1;
+
+    unsigned firing = 0; // fire() nesting level
+    bool dirty      = false; // are there unsubscribed slots to remove?
+
+    void flush();
 };
 
 template <typename... Ts>
 typename Event<Ts...>::Subscription Event<Ts...>::subscribe(Event<Ts...>::Callback cb)
 {
-    this->callbacks.push_back(cb);
-    return --this->callbacks.end();
+    Subscription subscription = this->nextSubscription++;
+
+    if (this->firing > 0)
+        this->pendingSlots.push_back({ subscription, std::move(cb), false });
+    else
+        this->slots.push_back({ subscription, std::move(cb), false });
+
+    return subscription;
+}
+
+template <typename... Ts>
+typename Event<Ts...>::ScopedSubscription Event<Ts...>::subscribeScoped(Event<Ts...>::Callback cb)
+{
+    return ScopedSubscription(this, this->subscribe(std::move(cb)));
 }
 
 template <typename... Ts>
 void Event<Ts...>::unsubscribe(Event<Ts...>::Subscription subscription)
 {
-    this->callbacks.erase(subscription);
+    auto compare = [](const Slot& slot, Subscription value) { return slot.subscription < value; };
+
+    auto it = std::lower_bound(this->slots.begin(), this->slots.end(), subscription, compare);
+
+    if (it != this->slots.end() && it->subscription == subscription)
+    {
+        // Don't touch the vector while iterating on it, the
+        // callback may even be the one currently running
+        if (this->firing > 0)
+        {
+            it->removed = true;
+            this->dirty = true;
+        }
+        else
+        {
+            this->slots.erase(it);
+        }
+
+        return;
+    }
+
+    // Not found, the subscription may still be pending
+    auto pending = std::lower_bound(this->pendingSlots.begin(), this->pendingSlots.end(), subscription, compare);
+
+    if (pending != this->pendingSlots.end() && pending->subscription == subscription)
+        this->pendingSlots.erase(pending);
 }
 
 template <typename... Ts>
 bool Event<Ts...>::fire(Ts... args)
 {
-    for (Callback cb : this->callbacks)
-        cb(args...);
+    bool fired = false;
+
+    this->firing++;
+
+    // The vector cannot be resized while firing: new subscribers go to
+    // pendingSlots and removed ones are only flagged until the last fire returns,
+    // so the reference stays valid as long as the event itself is alive
+    for (size_t i = 0; i < this->slots.size(); i++)
+    {
+        Slot& slot = this->slots[i];
+
+        if (slot.removed)
+            continue;
+
+        slot.callback(args...);
+        fired = true;
+    }
+
+    this->firing--;
+
+    if (this->firing == 0)
+        this->flush();
+
+    return fired;
+}
+
+template <typename... Ts>
+void Event<Ts...>::flush()
+{
+    if (this->dirty)
+    {
+        this->slots.erase(std::remove_if(this->slots.begin(), this->slots.end(), [](const Slot& slot) { return slot.removed; }), this->slots.end());
+        this->dirty = false;
+    }
 
-    return !this->callbacks.empty();
+    if (!this->pendingSlots.empty())
+    {
+        std::move(this->pendingSlots.begin(), this->pendingSlots.end(), std::back_inserter(this->slots));
+        this->pendingSlots.clear();
+    }
 }
 
 }; // namespace brls
@@ -672,6 +672,10 @@ NVGparams* nvgInternalParams(NVGcontext* ctx);
 // Debug function to dump cached path data.
 void nvgDebugDumpPathCache(NVGcontext* ctx);
 
+// Returns the number of draw calls and triangles issued since the last nvgBeginFrame().
+// Any of the pointers can be NULL.
+void nvgFrameStats(NVGcontext* ctx, int* drawCalls, int* triangles);
+
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -32,6 +32,15 @@ enum NVGcreateFlags {
 	NVG_STENCIL_STROKES	= 1<<1,
 	// Flag indicating that additional debug checks are done.
 	NVG_DEBUG 			= 1<<2,
+	// Flag indicating that vertices and uniforms are streamed through ring buffers of three segments, one
+	// per frame in flight, instead of reallocating the buffers every frame. With GL_ARB_buffer_storage the
+	// buffers are persistently mapped and vertices are written in place, otherwise glBufferSubData is used.
+	// Only supported by the GL3 backend.
+	NVG_RING_BUFFERS	= 1<<3,
+	// Flag indicating that consecutive convex fills and triangles (text) sharing blending and texture are
+	// merged into a single indexed draw, every vertex pointing to its own uniforms in an array.
+	// Only supported by the GL3 backend.
+	NVG_BATCH_DRAWS		= 1<<4,
 };
 
 #if defined NANOVG_GL2_IMPLEMENTATION
@@ -41,6 +50,8 @@ enum NVGcreateFlags {
 #  define NANOVG_GL3 1
 #  define NANOVG_GL_IMPLEMENTATION 1
 #  define NANOVG_GL_USE_UNIFORMBUFFER 1
+#  define NANOVG_GL_USE_RING_BUFFERS 1
+#  define NANOVG_GL_USE_BATCHING 1
 #elif defined NANOVG_GLES2_IMPLEMENTATION
 #  define NANOVG_GLES2 1
 #  define NANOVG_GL_IMPLEMENTATION 1
@@ -51,6 +62,12 @@ enum NVGcreateFlags {
 
 #define NANOVG_GL_USE_STATE_FILTER (1)
 
+// Runtime check for GL_ARB_buffer_storage, define it to match your GL
+// loader before including this file, e.g. GLAD_GL_ARB_buffer_storage
+#ifndef NANOVG_GL_HAS_BUFFER_STORAGE
+#  define NANOVG_GL_HAS_BUFFER_STORAGE 0
+#endif
+
 // Creates NanoVG contexts for different OpenGL (ES) versions.
 // Flags should be combination of the create flags above.
 
@@ -62,6 +79,9 @@ void nvgDeleteGL2(NVGcontext* ctx);
 int nvglCreateImageFromHandleGL2(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGL2(NVGcontext* ctx, int image);
 
+// Returns the number of GL draw calls issued by the last frame
+int nvglDrawCallsGL2(NVGcontext* ctx);
+
 #endif
 
 #if defined NANOVG_GL3
@@ -72,6 +92,9 @@ void nvgDeleteGL3(NVGcontext* ctx);
 int nvglCreateImageFromHandleGL3(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGL3(NVGcontext* ctx, int image);
 
+// Returns the number of GL draw calls issued by the last frame
+int nvglDrawCallsGL3(NVGcontext* ctx);
+
 #endif
 
 #if defined NANOVG_GLES2
@@ -82,6 +105,9 @@ void nvgDeleteGLES2(NVGcontext* ctx);
 int nvglCreateImageFromHandleGLES2(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGLES2(NVGcontext* ctx, int image);
 
+// Returns the number of GL draw calls issued by the last frame
+int nvglDrawCallsGLES2(NVGcontext* ctx);
+
 #endif
 
 #if defined NANOVG_GLES3
@@ -92,6 +118,9 @@ void nvgDeleteGLES3(NVGcontext* ctx);
 int nvglCreateImageFromHandleGLES3(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGLES3(NVGcontext* ctx, int image);
 
+// Returns the number of GL draw calls issued by the last frame
+int nvglDrawCallsGLES3(NVGcontext* ctx);
+
 #endif
 
 // These are additional flags on top of NVGimageFlags.
@@ -176,6 +205,13 @@ struct GLNVGcall {
 	int triangleCount;
 	int uniformOffset;
 	GLNVGblend blendFunc;
+#if NANOVG_GL_USE_BATCHING
+	// Set on the first call of a batch
+	int batchCount;		// calls drawn by the batch, 1 if not batched
+	int batchImage;
+	int indexOffset;
+	int indexCount;
+#endif
 };
 typedef struct GLNVGcall GLNVGcall;
 
@@ -187,6 +223,34 @@ struct GLNVGpath {
 };
 typedef struct GLNVGpath GLNVGpath;
 
+#if NANOVG_GL_USE_RING_BUFFERS
+#define GLNVG_RING_SEGMENTS 3
+#define GLNVG_RING_INIT_VERTS 16384
+#define GLNVG_RING_INIT_UNIFORMS 256
+
+enum GLNVGbufferMode {
+	GLNVG_BUFFERS_STREAM,		// glBufferData every frame: the buffer is orphaned and reallocated
+	GLNVG_BUFFERS_SUBDATA,		// glBufferSubData into the segment of the frame
+	GLNVG_BUFFERS_PERSISTENT,	// written into the mapped segment of the frame, once its fence is signaled
+};
+
+// A buffer split in segments, one per frame in flight
+struct GLNVGring {
+	GLenum target;
+	unsigned char* mapped;	// persistent mode only
+	int segmentSize;		// in bytes
+	int segment;			// segment of the current frame
+	GLsync fences[GLNVG_RING_SEGMENTS];
+};
+typedef struct GLNVGring GLNVGring;
+#endif
+
+#if NANOVG_GL_USE_BATCHING
+// Uniforms indexed by a batch, 16KB being the minimum uniform block size
+#define GLNVG_BATCH_MAX_UNIFORMS 64
+#define GLNVG_MIN_UNIFORM_BLOCK_SIZE 16384
+#endif
+
 struct GLNVGfragUniforms {
 	#if NANOVG_GL_USE_UNIFORMBUFFER
 		float scissorMat[12]; // matrices are actually 3 vec4s
@@ -259,6 +323,34 @@ struct GLNVGcontext {
 	int cuniforms;
 	int nuniforms;
 
+#if NANOVG_GL_USE_RING_BUFFERS
+	int bufferMode;
+	GLNVGring vertRing;
+	GLNVGring fragRing;
+	GLintptr vertBase;		// offset of the frame vertices in vertBuf
+	GLintptr fragBase;		// offset of the frame uniforms in fragBuf
+	int vertsMapped;		// verts points to the mapped segment of the frame
+#endif
+
+#if NANOVG_GL_USE_BATCHING
+	int fragCount;			// uniforms in the array indexed by a batch
+	GLuint vertFragBuf;
+	GLuint indexBuf;
+	float* vertFrags;		// per vertex index of the uniforms, relative to the batch
+	int cvertFrags;
+	GLuint* indices;		// triangles of the batches
+	int cindices;
+	int nindices;
+#if NANOVG_GL_USE_RING_BUFFERS
+	GLNVGring vertFragRing;
+	GLNVGring indexRing;
+	GLintptr vertFragBase;	// offset of the frame uniforms indexes in vertFragBuf
+	GLintptr indexBase;		// offset of the frame triangles in indexBuf
+#endif
+#endif
+
+	int drawCalls;			// issued by the last flush
+
 	// cached state
 	#if NANOVG_GL_USE_STATE_FILTER
 	GLuint boundTexture;
@@ -272,6 +364,9 @@ struct GLNVGcontext {
 typedef struct GLNVGcontext GLNVGcontext;
 
 static int glnvg__maxi(int a, int b) { return a > b ? a : b; }
+#if NANOVG_GL_USE_BATCHING
+static int glnvg__mini(int a, int b) { return a < b ? a : b; }
+#endif
 
 #ifdef NANOVG_GLES2
 static unsigned int glnvg__nearestPow2(unsigned int num)
@@ -463,6 +558,7 @@ static int glnvg__createShader(GLNVGshader* shader, const char* name, const char
 
 	glBindAttribLocation(prog, 0, "vertex");
 	glBindAttribLocation(prog, 1, "tcoord");
+	glBindAttribLocation(prog, 2, "fragIndex");
 
 	glLinkProgram(prog);
 	glGetProgramiv(prog, GL_LINK_STATUS, &status);
@@ -500,10 +596,176 @@ static void glnvg__getUniforms(GLNVGshader* shader)
 #endif
 }
 
+#if NANOVG_GL_USE_RING_BUFFERS
+static void glnvg__ringWait(GLNVGring* ring)
+{
+	GLsync fence = ring->fences[ring->segment];
+	if (fence == NULL) return;
+	// Poll first, only flush and block if the GPU is still reading the segment
+	if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+		while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED);
+	glDeleteSync(fence);
+	ring->fences[ring->segment] = NULL;
+}
+
+static void glnvg__ringDelete(GLNVGring* ring, GLuint* buf)
+{
+	int i;
+	for (i = 0; i < GLNVG_RING_SEGMENTS; i++) {
+		if (ring->fences[i] != NULL)
+			glDeleteSync(ring->fences[i]);
+		ring->fences[i] = NULL;
+	}
+	if (*buf != 0) {
+		if (ring->mapped != NULL) {
+			glBindBuffer(ring->target, *buf);
+			glUnmapBuffer(ring->target);
+		}
+		glDeleteBuffers(1, buf);
+	}
+	*buf = 0;
+	ring->mapped = NULL;
+	ring->segmentSize = 0;
+	ring->segment = 0;
+}
+
+// (Re)creates the buffer, storage is immutable in persistent mode
+static int glnvg__ringCreate(GLNVGcontext* gl, GLNVGring* ring, GLuint* buf, int segmentSize)
+{
+	GLsizeiptr size = (GLsizeiptr)segmentSize * GLNVG_RING_SEGMENTS;
+
+	glnvg__ringDelete(ring, buf);
+	glGenBuffers(1, buf);
+	glBindBuffer(ring->target, *buf);
+
+#ifdef GL_MAP_PERSISTENT_BIT
+	if (gl->bufferMode == GLNVG_BUFFERS_PERSISTENT) {
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(ring->target, size, NULL, flags);
+		ring->mapped = (unsigned char*)glMapBufferRange(ring->target, 0, size, flags);
+		if (ring->mapped == NULL) return 0;
+	} else
+#endif
+	{
+		glBufferData(ring->target, size, NULL, GL_DYNAMIC_DRAW);
+	}
+
+	ring->segmentSize = segmentSize;
+	glBindBuffer(ring->target, 0);
+	return 1;
+}
+
+// Grows the segments to hold at least size bytes, rounded up to unit
+static int glnvg__ringReserve(GLNVGcontext* gl, GLNVGring* ring, GLuint* buf, int size, int unit)
+{
+	int segmentSize;
+	if (size <= ring->segmentSize) return 1;
+	segmentSize = glnvg__maxi(size, ring->segmentSize + ring->segmentSize/2); // 1.5x Overallocate
+	segmentSize = (segmentSize + unit - 1) / unit * unit;
+	return glnvg__ringCreate(gl, ring, buf, segmentSize);
+}
+
+// Copies the data of the frame into its segment, returns the offset of the segment
+static GLintptr glnvg__ringUpload(GLNVGcontext* gl, GLNVGring* ring, GLuint buf, const void* data, int size)
+{
+	GLintptr offset = (GLintptr)ring->segment * ring->segmentSize;
+
+	if (gl->bufferMode == GLNVG_BUFFERS_PERSISTENT) {
+		glnvg__ringWait(ring);
+		memcpy(ring->mapped + offset, data, size);
+	} else {
+		glBindBuffer(ring->target, buf);
+		glBufferSubData(ring->target, offset, size, data);
+	}
+
+	return offset;
+}
+
+// Fences the segment of the frame, once its draws have been issued
+static void glnvg__ringAdvance(GLNVGcontext* gl, GLNVGring* ring)
+{
+	if (gl->bufferMode == GLNVG_BUFFERS_PERSISTENT)
+		ring->fences[ring->segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	ring->segment = (ring->segment + 1) % GLNVG_RING_SEGMENTS;
+}
+
+static int glnvg__createRings(GLNVGcontext* gl)
+{
+	gl->vertRing.target = GL_ARRAY_BUFFER;
+	gl->fragRing.target = GL_UNIFORM_BUFFER;
+
+	if (glnvg__ringCreate(gl, &gl->vertRing, &gl->vertBuf, GLNVG_RING_INIT_VERTS * sizeof(NVGvertex)) == 0)
+		return 0;
+	if (glnvg__ringCreate(gl, &gl->fragRing, &gl->fragBuf, GLNVG_RING_INIT_UNIFORMS * gl->fragSize) == 0)
+		return 0;
+
+#if NANOVG_GL_USE_BATCHING
+	if (gl->flags & NVG_BATCH_DRAWS) {
+		// Not created as an element buffer, to leave the bound vertex array alone
+		gl->vertFragRing.target = GL_ARRAY_BUFFER;
+		gl->indexRing.target = GL_COPY_WRITE_BUFFER;
+
+		if (glnvg__ringCreate(gl, &gl->vertFragRing, &gl->vertFragBuf, GLNVG_RING_INIT_VERTS * sizeof(float)) == 0)
+			return 0;
+		if (glnvg__ringCreate(gl, &gl->indexRing, &gl->indexBuf, GLNVG_RING_INIT_VERTS * sizeof(GLuint)) == 0)
+			return 0;
+	}
+#endif
+
+	return 1;
+}
+
+// Points verts to the mapped segment of the frame, for vertices to be written in place
+static void glnvg__mapVerts(GLNVGcontext* gl)
+{
+	GLNVGring* ring = &gl->vertRing;
+	glnvg__ringWait(ring);
+	gl->verts = (NVGvertex*)(ring->mapped + (size_t)ring->segment * ring->segmentSize);
+	gl->cverts = ring->segmentSize / sizeof(NVGvertex);
+	gl->vertsMapped = 1;
+}
+
+// Grows the vertices ring when a frame outgrows its mapped segment. The mapped memory is
+// write only (and usually write combined) so it's never read back: the vertices written
+// so far are copied by the GPU to the first segment of the new buffer, then the frame
+// goes on writing in place after them
+static int glnvg__growMappedVerts(GLNVGcontext* gl, int nverts)
+{
+	GLNVGring* ring = &gl->vertRing;
+	GLuint oldBuf = gl->vertBuf;
+	GLintptr oldOffset = (GLintptr)ring->segment * ring->segmentSize;
+	int segmentSize = glnvg__maxi(nverts * (int)sizeof(NVGvertex), ring->segmentSize + ring->segmentSize/2); // 1.5x Overallocate
+	segmentSize = (segmentSize + (int)sizeof(NVGvertex) - 1) / (int)sizeof(NVGvertex) * (int)sizeof(NVGvertex);
+
+	// Keep the old buffer until the copy is issued, its fences are not needed anymore
+	glBindBuffer(GL_ARRAY_BUFFER, oldBuf);
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	ring->mapped = NULL;
+	gl->vertBuf = 0;
+
+	if (glnvg__ringCreate(gl, ring, &gl->vertBuf, segmentSize) == 0) {
+		glDeleteBuffers(1, &oldBuf);
+		return 0;
+	}
+
+	glBindBuffer(GL_COPY_READ_BUFFER, oldBuf);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, gl->vertBuf);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, oldOffset, 0, (GLsizeiptr)gl->nverts * sizeof(NVGvertex));
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	glDeleteBuffers(1, &oldBuf);
+
+	glnvg__mapVerts(gl);
+	return 1;
+}
+#endif
+
 static int glnvg__renderCreate(void* uptr)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
 	int align = 4;
+	char opts[128] = "";
 
 	// TODO: mediump float may not be enough for GLES2 in iOS.
 	// see the following discussion: https://github.com/memononen/nanovg/issues/46
@@ -535,6 +797,10 @@ static int glnvg__renderCreate(void* uptr)
 		"	in vec2 tcoord;\n"
 		"	out vec2 ftcoord;\n"
 		"	out vec2 fpos;\n"
+		"#ifdef BATCHING\n"
+		"	in float fragIndex;\n"
+		"	flat out int findex;\n"
+		"#endif\n"
 		"#else\n"
 		"	uniform vec2 viewSize;\n"
 		"	attribute vec2 vertex;\n"
@@ -545,6 +811,9 @@ static int glnvg__renderCreate(void* uptr)
 		"void main(void) {\n"
 		"	ftcoord = tcoord;\n"
 		"	fpos = vertex;\n"
+		"#ifdef BATCHING\n"
+		"	findex = int(fragIndex);\n"
+		"#endif\n"
 		"	gl_Position = vec4(2.0*vertex.x/viewSize.x - 1.0, 1.0 - 2.0*vertex.y/viewSize.y, 0, 1);\n"
 		"}\n";
 
@@ -557,7 +826,43 @@ static int glnvg__renderCreate(void* uptr)
 		"#endif\n"
 		"#endif\n"
 		"#ifdef NANOVG_GL3\n"
-		"#ifdef USE_UNIFORMBUFFER\n"
+		"#if defined(USE_UNIFORMBUFFER) && defined(BATCHING)\n"
+		"	struct Frag {\n"
+		"		mat3 scissorMat;\n"
+		"		mat3 paintMat;\n"
+		"		vec4 innerCol;\n"
+		"		vec4 outerCol;\n"
+		"		vec2 scissorExt;\n"
+		"		vec2 scissorScale;\n"
+		"		vec2 extent;\n"
+		"		float radius;\n"
+		"		float feather;\n"
+		"		float strokeMult;\n"
+		"		float strokeThr;\n"
+		"		int texType;\n"
+		"		int type;\n"
+		"#if FRAG_PADDING > 0\n"
+		"		vec4 padding[FRAG_PADDING];\n" // up to the uniform buffer offset alignment
+		"#endif\n"
+		"	};\n"
+		"	layout(std140) uniform frag {\n"
+		"		Frag frags[FRAG_COUNT];\n"
+		"	};\n"
+		"	flat in int findex;\n"
+		"	#define scissorMat frags[findex].scissorMat\n"
+		"	#define paintMat frags[findex].paintMat\n"
+		"	#define innerCol frags[findex].innerCol\n"
+		"	#define outerCol frags[findex].outerCol\n"
+		"	#define scissorExt frags[findex].scissorExt\n"
+		"	#define scissorScale frags[findex].scissorScale\n"
+		"	#define extent frags[findex].extent\n"
+		"	#define radius frags[findex].radius\n"
+		"	#define feather frags[findex].feather\n"
+		"	#define strokeMult frags[findex].strokeMult\n"
+		"	#define strokeThr frags[findex].strokeThr\n"
+		"	#define texType frags[findex].texType\n"
+		"	#define type frags[findex].type\n"
+		"#elif defined(USE_UNIFORMBUFFER)\n"
 		"	layout(std140) uniform frag {\n"
 		"		mat3 scissorMat;\n"
 		"		mat3 paintMat;\n"
@@ -675,13 +980,30 @@ static int glnvg__renderCreate(void* uptr)
 
 	glnvg__checkError(gl, "init");
 
-	if (gl->flags & NVG_ANTIALIAS) {
-		if (glnvg__createShader(&gl->shader, "shader", shaderHeader, "#define EDGE_AA 1\n", fillVertShader, fillFragShader) == 0)
-			return 0;
-	} else {
-		if (glnvg__createShader(&gl->shader, "shader", shaderHeader, NULL, fillVertShader, fillFragShader) == 0)
-			return 0;
+#if NANOVG_GL_USE_UNIFORMBUFFER
+	// The uniforms size is needed by the batching shader
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align);
+#endif
+#if NANOVG_GL_USE_BATCHING
+	// Batches index the uniforms as an std140 array, their stride must be a multiple of a vec4
+	if (gl->flags & NVG_BATCH_DRAWS)
+		align = glnvg__maxi(align, 16);
+#endif
+	gl->fragSize = sizeof(GLNVGfragUniforms) + align - sizeof(GLNVGfragUniforms) % align;
+
+	if (gl->flags & NVG_ANTIALIAS)
+		strcat(opts, "#define EDGE_AA 1\n");
+
+#if NANOVG_GL_USE_BATCHING
+	if (gl->flags & NVG_BATCH_DRAWS) {
+		gl->fragCount = glnvg__mini(GLNVG_BATCH_MAX_UNIFORMS, GLNVG_MIN_UNIFORM_BLOCK_SIZE / gl->fragSize);
+		snprintf(opts + strlen(opts), sizeof(opts) - strlen(opts), "#define BATCHING 1\n#define FRAG_COUNT %d\n#define FRAG_PADDING %d\n",
+			gl->fragCount, (int)(gl->fragSize - sizeof(GLNVGfragUniforms)) / 16);
 	}
+#endif
+
+	if (glnvg__createShader(&gl->shader, "shader", shaderHeader, opts, fillVertShader, fillFragShader) == 0)
+		return 0;
 
 	glnvg__checkError(gl, "uniform locations");
 	glnvg__getUniforms(&gl->shader);
@@ -696,9 +1018,27 @@ static int glnvg__renderCreate(void* uptr)
 	// Create UBOs
 	glUniformBlockBinding(gl->shader.prog, gl->shader.loc[GLNVG_LOC_FRAG], GLNVG_FRAG_BINDING);
 	glGenBuffers(1, &gl->fragBuf);
-	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align);
 #endif
-	gl->fragSize = sizeof(GLNVGfragUniforms) + align - sizeof(GLNVGfragUniforms) % align;
+
+#if NANOVG_GL_USE_BATCHING
+	if (gl->flags & NVG_BATCH_DRAWS) {
+		glGenBuffers(1, &gl->vertFragBuf);
+		glGenBuffers(1, &gl->indexBuf);
+	}
+#endif
+
+#if NANOVG_GL_USE_RING_BUFFERS
+	gl->bufferMode = GLNVG_BUFFERS_STREAM;
+	if (gl->flags & NVG_RING_BUFFERS) {
+		gl->bufferMode = NANOVG_GL_HAS_BUFFER_STORAGE ? GLNVG_BUFFERS_PERSISTENT : GLNVG_BUFFERS_SUBDATA;
+		if (glnvg__createRings(gl) == 0) {
+			// Mapping failed, use regular buffers
+			gl->bufferMode = GLNVG_BUFFERS_SUBDATA;
+			if (glnvg__createRings(gl) == 0)
+				return 0;
+		}
+	}
+#endif
 
 	glnvg__checkError(gl, "create done");
 
@@ -970,10 +1310,20 @@ static int glnvg__convertPaint(GLNVGcontext* gl, GLNVGfragUniforms* frag, NVGpai
 }
 
 static GLNVGfragUniforms* nvg__fragUniformPtr(GLNVGcontext* gl, int i);
+static int glnvg__allocFragUniforms(GLNVGcontext* gl, int n);
 
 static void glnvg__setUniforms(GLNVGcontext* gl, int uniformOffset, int image)
 {
 #if NANOVG_GL_USE_UNIFORMBUFFER
+#if NANOVG_GL_USE_RING_BUFFERS
+	uniformOffset += gl->fragBase;
+#endif
+#if NANOVG_GL_USE_BATCHING
+	// The whole array is bound, a frame ends with enough padding for it
+	if (gl->flags & NVG_BATCH_DRAWS) {
+		glBindBufferRange(GL_UNIFORM_BUFFER, GLNVG_FRAG_BINDING, gl->fragBuf, uniformOffset, gl->fragCount * gl->fragSize);
+	} else
+#endif
 	glBindBufferRange(GL_UNIFORM_BUFFER, GLNVG_FRAG_BINDING, gl->fragBuf, uniformOffset, sizeof(GLNVGfragUniforms));
 #else
 	GLNVGfragUniforms* frag = nvg__fragUniformPtr(gl, uniformOffset);
@@ -997,6 +1347,12 @@ static void glnvg__renderViewport(void* uptr, float width, float height, float d
 	gl->view[1] = height;
 }
 
+static void glnvg__drawArrays(GLNVGcontext* gl, GLenum mode, GLint first, GLsizei count)
+{
+	glDrawArrays(mode, first, count);
+	gl->drawCalls++;
+}
+
 static void glnvg__fill(GLNVGcontext* gl, GLNVGcall* call)
 {
 	GLNVGpath* paths = &gl->paths[call->pathOffset];
@@ -1016,7 +1372,7 @@ static void glnvg__fill(GLNVGcontext* gl, GLNVGcall* call)
 	glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_DECR_WRAP);
 	glDisable(GL_CULL_FACE);
 	for (i = 0; i < npaths; i++)
-		glDrawArrays(GL_TRIANGLE_FAN, paths[i].fillOffset, paths[i].fillCount);
+		glnvg__drawArrays(gl, GL_TRIANGLE_FAN, paths[i].fillOffset, paths[i].fillCount);
 	glEnable(GL_CULL_FACE);
 
 	// Draw anti-aliased pixels
@@ -1030,13 +1386,13 @@ static void glnvg__fill(GLNVGcontext* gl, GLNVGcall* call)
 		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 		// Draw fringes
 		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+			glnvg__drawArrays(gl, GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
 	}
 
 	// Draw fill
 	glnvg__stencilFunc(gl, GL_NOTEQUAL, 0x0, 0xff);
 	glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
-	glDrawArrays(GL_TRIANGLE_STRIP, call->triangleOffset, call->triangleCount);
+	glnvg__drawArrays(gl, GL_TRIANGLE_STRIP, call->triangleOffset, call->triangleCount);
 
 	glDisable(GL_STENCIL_TEST);
 }
@@ -1050,10 +1406,10 @@ static void glnvg__convexFill(GLNVGcontext* gl, GLNVGcall* call)
 	glnvg__checkError(gl, "convex fill");
 
 	for (i = 0; i < npaths; i++) {
-		glDrawArrays(GL_TRIANGLE_FAN, paths[i].fillOffset, paths[i].fillCount);
+		glnvg__drawArrays(gl, GL_TRIANGLE_FAN, paths[i].fillOffset, paths[i].fillCount);
 		// Draw fringes
 		if (paths[i].strokeCount > 0) {
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+			glnvg__drawArrays(gl, GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
 		}
 	}
 }
@@ -1074,14 +1430,14 @@ static void glnvg__stroke(GLNVGcontext* gl, GLNVGcall* call)
 		glnvg__setUniforms(gl, call->uniformOffset + gl->fragSize, call->image);
 		glnvg__checkError(gl, "stroke fill 0");
 		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+			glnvg__drawArrays(gl, GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
 
 		// Draw anti-aliased pixels.
 		glnvg__setUniforms(gl, call->uniformOffset, call->image);
 		glnvg__stencilFunc(gl, GL_EQUAL, 0x00, 0xff);
 		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+			glnvg__drawArrays(gl, GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
 
 		// Clear stencil buffer.
 		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
@@ -1089,7 +1445,7 @@ static void glnvg__stroke(GLNVGcontext* gl, GLNVGcall* call)
 		glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
 		glnvg__checkError(gl, "stroke fill 1");
 		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+			glnvg__drawArrays(gl, GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
 		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 
 		glDisable(GL_STENCIL_TEST);
@@ -1101,7 +1457,7 @@ static void glnvg__stroke(GLNVGcontext* gl, GLNVGcall* call)
 		glnvg__checkError(gl, "stroke fill");
 		// Draw Strokes
 		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+			glnvg__drawArrays(gl, GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
 	}
 }
 
@@ -1110,9 +1466,174 @@ static void glnvg__triangles(GLNVGcontext* gl, GLNVGcall* call)
 	glnvg__setUniforms(gl, call->uniformOffset, call->image);
 	glnvg__checkError(gl, "triangles fill");
 
-	glDrawArrays(GL_TRIANGLES, call->triangleOffset, call->triangleCount);
+	glnvg__drawArrays(gl, GL_TRIANGLES, call->triangleOffset, call->triangleCount);
+}
+
+#if NANOVG_GL_USE_BATCHING
+static int glnvg__batchable(const GLNVGcall* call)
+{
+	// Single pass calls, without stencil
+	return call->type == GLNVG_CONVEXFILL || call->type == GLNVG_TRIANGLES;
+}
+
+static int glnvg__batchIndexCount(GLNVGcontext* gl, const GLNVGcall* call)
+{
+	GLNVGpath* paths = &gl->paths[call->pathOffset];
+	int i, count = 0;
+
+	if (call->type == GLNVG_TRIANGLES)
+		return call->triangleCount;
+
+	for (i = 0; i < call->pathCount; i++) {
+		count += glnvg__maxi(paths[i].fillCount - 2, 0) * 3;
+		count += glnvg__maxi(paths[i].strokeCount - 2, 0) * 3;
+	}
+	return count;
+}
+
+static GLuint* glnvg__allocIndices(GLNVGcontext* gl, int n)
+{
+	GLuint* ret = NULL;
+	if (gl->nindices+n > gl->cindices) {
+		GLuint* indices;
+		int cindices = glnvg__maxi(gl->nindices+n, 4096) + gl->cindices/2; // 1.5x Overallocate
+		indices = (GLuint*)realloc(gl->indices, sizeof(GLuint) * cindices);
+		if (indices == NULL) return NULL;
+		gl->indices = indices;
+		gl->cindices = cindices;
+	}
+	ret = &gl->indices[gl->nindices];
+	gl->nindices += n;
+	return ret;
+}
+
+// Writes the triangles of a call as a list, along with the uniforms index of its vertices
+static GLuint* glnvg__batchTriangles(GLNVGcontext* gl, const GLNVGcall* call, float fragIndex, GLuint* idx)
+{
+	GLNVGpath* paths = &gl->paths[call->pathOffset];
+	int i, j;
+	GLuint v;
+
+	if (call->type == GLNVG_TRIANGLES) {
+		for (j = 0; j < call->triangleCount; j++) {
+			*idx++ = call->triangleOffset + j;
+			gl->vertFrags[call->triangleOffset + j] = fragIndex;
+		}
+		return idx;
+	}
+
+	for (i = 0; i < call->pathCount; i++) {
+		GLNVGpath* path = &paths[i];
+
+		// Fill fan
+		for (j = 1; j < path->fillCount - 1; j++) {
+			*idx++ = path->fillOffset;
+			*idx++ = path->fillOffset + j;
+			*idx++ = path->fillOffset + j + 1;
+		}
+		for (j = 0; j < path->fillCount; j++)
+			gl->vertFrags[path->fillOffset + j] = fragIndex;
+
+		// Fringe strip, odd triangles are swapped to keep the winding of the strip
+		for (j = 0; j < path->strokeCount - 2; j++) {
+			v = path->strokeOffset + j;
+			*idx++ = (j & 1) ? v + 1 : v;
+			*idx++ = (j & 1) ? v : v + 1;
+			*idx++ = v + 2;
+		}
+		for (j = 0; j < path->strokeCount; j++)
+			gl->vertFrags[path->strokeOffset + j] = fragIndex;
+	}
+
+	return idx;
+}
+
+// Groups consecutive batchable calls sharing blending and texture, untextured calls going
+// with any texture since they don't sample it, as long as their uniforms fit in the array
+// bound for the batch. Returns 0 if there is nothing to batch.
+static int glnvg__buildBatches(GLNVGcontext* gl)
+{
+	GLNVGcall* first;
+	GLuint* idx;
+	int i, j, k, image, count;
+
+	gl->nindices = 0;
+
+	if (gl->nverts > gl->cvertFrags) {
+		float* vertFrags;
+		int cvertFrags = glnvg__maxi(gl->nverts, 4096) + gl->cvertFrags/2; // 1.5x Overallocate
+		vertFrags = (float*)realloc(gl->vertFrags, sizeof(float) * cvertFrags);
+		if (vertFrags == NULL) return 0;
+		gl->vertFrags = vertFrags;
+		gl->cvertFrags = cvertFrags;
+	}
+
+	// Vertices of calls drawn on their own use the uniforms bound for them
+	memset(gl->vertFrags, 0, sizeof(float) * gl->nverts);
+
+	for (i = 0; i < gl->ncalls; i = j) {
+		first = &gl->calls[i];
+		first->batchCount = 1;
+		j = i + 1;
+
+		if (!glnvg__batchable(first))
+			continue;
+
+		image = first->image;
+		count = glnvg__batchIndexCount(gl, first);
+
+		for (; j < gl->ncalls; j++) {
+			GLNVGcall* call = &gl->calls[j];
+			if (!glnvg__batchable(call))
+				break;
+			if (memcmp(&call->blendFunc, &first->blendFunc, sizeof(GLNVGblend)) != 0)
+				break;
+			if (call->image != 0 && image != 0 && call->image != image)
+				break;
+			if ((call->uniformOffset - first->uniformOffset) / gl->fragSize >= gl->fragCount)
+				break;
+			if (call->image != 0)
+				image = call->image;
+			count += glnvg__batchIndexCount(gl, call);
+		}
+
+		if (j - i < 2)
+			continue;
+
+		idx = glnvg__allocIndices(gl, count);
+		if (idx == NULL) {
+			j = i + 1;
+			continue;
+		}
+
+		first->batchCount = j - i;
+		first->batchImage = image;
+		first->indexOffset = gl->nindices - count;
+		first->indexCount = count;
+
+		for (k = i; k < j; k++) {
+			GLNVGcall* call = &gl->calls[k];
+			idx = glnvg__batchTriangles(gl, call, (float)((call->uniformOffset - first->uniformOffset) / gl->fragSize), idx);
+		}
+	}
+
+	return gl->nindices > 0;
 }
 
+static void glnvg__batch(GLNVGcontext* gl, GLNVGcall* call)
+{
+	glnvg__setUniforms(gl, call->uniformOffset, call->batchImage);
+	glnvg__checkError(gl, "batch");
+
+#if NANOVG_GL_USE_RING_BUFFERS
+	glDrawElements(GL_TRIANGLES, call->indexCount, GL_UNSIGNED_INT, (const GLvoid*)(gl->indexBase + call->indexOffset * sizeof(GLuint)));
+#else
+	glDrawElements(GL_TRIANGLES, call->indexCount, GL_UNSIGNED_INT, (const GLvoid*)(call->indexOffset * sizeof(GLuint)));
+#endif
+	gl->drawCalls++;
+}
+#endif
+
 static void glnvg__renderCancel(void* uptr) {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
 	gl->nverts = 0;
@@ -1169,9 +1690,26 @@ static void glnvg__renderFlush(void* uptr)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
 	int i;
+#if NANOVG_GL_USE_BATCHING
+	int batching = 0;
+#endif
+
+	gl->drawCalls = 0;
 
 	if (gl->ncalls > 0) {
 
+#if NANOVG_GL_USE_BATCHING
+		if (gl->flags & NVG_BATCH_DRAWS) {
+			// Padding for the uniforms array bound for the last uniforms of the frame
+			if (glnvg__allocFragUniforms(gl, gl->fragCount - 1) == -1) {
+				glnvg__renderCancel(gl);
+				return;
+			}
+
+			batching = glnvg__buildBatches(gl);
+		}
+#endif
+
 		// Setup require GL state.
 		glUseProgram(gl->shader.prog);
 
@@ -1199,22 +1737,78 @@ static void glnvg__renderFlush(void* uptr)
 		gl->blendFunc.dstAlpha = GL_INVALID_ENUM;
 		#endif
 
+#if NANOVG_GL_USE_RING_BUFFERS
+		if (gl->bufferMode != GLNVG_BUFFERS_STREAM) {
+			// Upload ubo for frag shaders
+			glnvg__ringReserve(gl, &gl->fragRing, &gl->fragBuf, gl->nuniforms * gl->fragSize, gl->fragSize);
+			gl->fragBase = glnvg__ringUpload(gl, &gl->fragRing, gl->fragBuf, gl->uniforms, gl->nuniforms * gl->fragSize);
+
+			// Upload vertex data, unless it was written in place
+			if (gl->vertsMapped) {
+				gl->vertBase = (GLintptr)gl->vertRing.segment * gl->vertRing.segmentSize;
+			} else {
+				glnvg__ringReserve(gl, &gl->vertRing, &gl->vertBuf, gl->nverts * sizeof(NVGvertex), sizeof(NVGvertex));
+				gl->vertBase = glnvg__ringUpload(gl, &gl->vertRing, gl->vertBuf, gl->verts, gl->nverts * sizeof(NVGvertex));
+			}
+
+			glBindVertexArray(gl->vertArr);
+			glBindBuffer(GL_ARRAY_BUFFER, gl->vertBuf);
+		} else
+#endif
+		{
 #if NANOVG_GL_USE_UNIFORMBUFFER
-		// Upload ubo for frag shaders
-		glBindBuffer(GL_UNIFORM_BUFFER, gl->fragBuf);
-		glBufferData(GL_UNIFORM_BUFFER, gl->nuniforms * gl->fragSize, gl->uniforms, GL_STREAM_DRAW);
+			// Upload ubo for frag shaders
+			glBindBuffer(GL_UNIFORM_BUFFER, gl->fragBuf);
+			glBufferData(GL_UNIFORM_BUFFER, gl->nuniforms * gl->fragSize, gl->uniforms, GL_STREAM_DRAW);
 #endif
 
-		// Upload vertex data
+			// Upload vertex data
 #if defined NANOVG_GL3
-		glBindVertexArray(gl->vertArr);
+			glBindVertexArray(gl->vertArr);
 #endif
-		glBindBuffer(GL_ARRAY_BUFFER, gl->vertBuf);
-		glBufferData(GL_ARRAY_BUFFER, gl->nverts * sizeof(NVGvertex), gl->verts, GL_STREAM_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, gl->vertBuf);
+			glBufferData(GL_ARRAY_BUFFER, gl->nverts * sizeof(NVGvertex), gl->verts, GL_STREAM_DRAW);
+		}
 		glEnableVertexAttribArray(0);
 		glEnableVertexAttribArray(1);
+#if NANOVG_GL_USE_RING_BUFFERS
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(size_t)gl->vertBase);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(gl->vertBase + 2*sizeof(float)));
+#else
 		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(size_t)0);
 		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(0 + 2*sizeof(float)));
+#endif
+
+#if NANOVG_GL_USE_BATCHING
+		if (batching) {
+			// Uniforms index of every vertex, and triangles of the batches
+#if NANOVG_GL_USE_RING_BUFFERS
+			if (gl->bufferMode != GLNVG_BUFFERS_STREAM) {
+				glnvg__ringReserve(gl, &gl->vertFragRing, &gl->vertFragBuf, gl->nverts * sizeof(float), sizeof(float));
+				gl->vertFragBase = glnvg__ringUpload(gl, &gl->vertFragRing, gl->vertFragBuf, gl->vertFrags, gl->nverts * sizeof(float));
+
+				glnvg__ringReserve(gl, &gl->indexRing, &gl->indexBuf, gl->nindices * sizeof(GLuint), sizeof(GLuint));
+				gl->indexBase = glnvg__ringUpload(gl, &gl->indexRing, gl->indexBuf, gl->indices, gl->nindices * sizeof(GLuint));
+
+				glBindBuffer(GL_ARRAY_BUFFER, gl->vertFragBuf);
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gl->indexBuf);
+			} else
+#endif
+			{
+				glBindBuffer(GL_ARRAY_BUFFER, gl->vertFragBuf);
+				glBufferData(GL_ARRAY_BUFFER, gl->nverts * sizeof(float), gl->vertFrags, GL_STREAM_DRAW);
+
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gl->indexBuf);
+				glBufferData(GL_ELEMENT_ARRAY_BUFFER, gl->nindices * sizeof(GLuint), gl->indices, GL_STREAM_DRAW);
+			}
+			glEnableVertexAttribArray(2);
+#if NANOVG_GL_USE_RING_BUFFERS
+			glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(float), (const GLvoid*)(size_t)gl->vertFragBase);
+#else
+			glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(float), (const GLvoid*)0);
+#endif
+		}
+#endif
 
 		// Set view and texture just once per frame.
 		glUniform1i(gl->shader.loc[GLNVG_LOC_TEX], 0);
@@ -1227,6 +1821,13 @@ static void glnvg__renderFlush(void* uptr)
 		for (i = 0; i < gl->ncalls; i++) {
 			GLNVGcall* call = &gl->calls[i];
 			glnvg__blendFuncSeparate(gl,&call->blendFunc);
+#if NANOVG_GL_USE_BATCHING
+			if (batching && call->batchCount > 1) {
+				glnvg__batch(gl, call);
+				i += call->batchCount - 1;
+				continue;
+			}
+#endif
 			if (call->type == GLNVG_FILL)
 				glnvg__fill(gl, call);
 			else if (call->type == GLNVG_CONVEXFILL)
@@ -1239,6 +1840,10 @@ static void glnvg__renderFlush(void* uptr)
 
 		glDisableVertexAttribArray(0);
 		glDisableVertexAttribArray(1);
+#if NANOVG_GL_USE_BATCHING
+		if (batching)
+			glDisableVertexAttribArray(2);
+#endif
 #if defined NANOVG_GL3
 		glBindVertexArray(0);
 #endif
@@ -1246,8 +1851,30 @@ static void glnvg__renderFlush(void* uptr)
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
 		glUseProgram(0);
 		glnvg__bindTexture(gl, 0);
+
+#if NANOVG_GL_USE_RING_BUFFERS
+		if (gl->bufferMode != GLNVG_BUFFERS_STREAM) {
+			glnvg__ringAdvance(gl, &gl->vertRing);
+			glnvg__ringAdvance(gl, &gl->fragRing);
+#if NANOVG_GL_USE_BATCHING
+			if (batching) {
+				glnvg__ringAdvance(gl, &gl->vertFragRing);
+				glnvg__ringAdvance(gl, &gl->indexRing);
+			}
+#endif
+		}
+#endif
 	}
 
+#if NANOVG_GL_USE_RING_BUFFERS
+	// The next frame starts on the next segment
+	if (gl->bufferMode == GLNVG_BUFFERS_PERSISTENT) {
+		gl->verts = NULL;
+		gl->cverts = 0;
+		gl->vertsMapped = 0;
+	}
+#endif
+
 	// Reset calls
 	gl->nverts = 0;
 	gl->npaths = 0;
@@ -1300,13 +1927,34 @@ static int glnvg__allocPaths(GLNVGcontext* gl, int n)
 static int glnvg__allocVerts(GLNVGcontext* gl, int n)
 {
 	int ret = 0;
+#if NANOVG_GL_USE_RING_BUFFERS
+	if (gl->bufferMode == GLNVG_BUFFERS_PERSISTENT && gl->nverts == 0 && !gl->vertsMapped)
+		glnvg__mapVerts(gl);
+#endif
 	if (gl->nverts+n > gl->cverts) {
 		NVGvertex* verts;
 		int cverts = glnvg__maxi(gl->nverts + n, 4096) + gl->cverts/2; // 1.5x Overallocate
-		verts = (NVGvertex*)realloc(gl->verts, sizeof(NVGvertex) * cverts);
-		if (verts == NULL) return -1;
-		gl->verts = verts;
-		gl->cverts = cverts;
+#if NANOVG_GL_USE_RING_BUFFERS
+		if (gl->vertsMapped) {
+			if (glnvg__growMappedVerts(gl, gl->nverts + n) == 0) {
+				// Out of memory: drop what was drawn so far and go on with regular buffers
+				gl->bufferMode = GLNVG_BUFFERS_SUBDATA;
+				gl->verts = NULL;
+				gl->cverts = 0;
+				gl->vertsMapped = 0;
+				gl->nverts = 0;
+				gl->ncalls = 0;
+				glnvg__createRings(gl);
+				return -1;
+			}
+		} else
+#endif
+		{
+			verts = (NVGvertex*)realloc(gl->verts, sizeof(NVGvertex) * cverts);
+			if (verts == NULL) return -1;
+			gl->verts = verts;
+			gl->cverts = cverts;
+		}
 	}
 	ret = gl->nverts;
 	gl->nverts += n;
@@ -1523,6 +2171,19 @@ static void glnvg__renderDelete(void* uptr)
 
 	glnvg__deleteShader(&gl->shader);
 
+#if NANOVG_GL_USE_RING_BUFFERS
+	if (gl->bufferMode != GLNVG_BUFFERS_STREAM) {
+		glnvg__ringDelete(&gl->vertRing, &gl->vertBuf);
+		glnvg__ringDelete(&gl->fragRing, &gl->fragBuf);
+#if NANOVG_GL_USE_BATCHING
+		if (gl->flags & NVG_BATCH_DRAWS) {
+			glnvg__ringDelete(&gl->vertFragRing, &gl->vertFragBuf);
+			glnvg__ringDelete(&gl->indexRing, &gl->indexBuf);
+		}
+#endif
+	}
+#endif
+
 #if NANOVG_GL3
 #if NANOVG_GL_USE_UNIFORMBUFFER
 	if (gl->fragBuf != 0)
@@ -1530,6 +2191,12 @@ static void glnvg__renderDelete(void* uptr)
 #endif
 	if (gl->vertArr != 0)
 		glDeleteVertexArrays(1, &gl->vertArr);
+#endif
+#if NANOVG_GL_USE_BATCHING
+	if (gl->vertFragBuf != 0)
+		glDeleteBuffers(1, &gl->vertFragBuf);
+	if (gl->indexBuf != 0)
+		glDeleteBuffers(1, &gl->indexBuf);
 #endif
 	if (gl->vertBuf != 0)
 		glDeleteBuffers(1, &gl->vertBuf);
@@ -1541,9 +2208,19 @@ static void glnvg__renderDelete(void* uptr)
 	free(gl->textures);
 
 	free(gl->paths);
+#if NANOVG_GL_USE_RING_BUFFERS
+	// verts may point to the mapped buffer
+	if (!gl->vertsMapped)
+		free(gl->verts);
+#else
 	free(gl->verts);
+#endif
 	free(gl->uniforms);
 	free(gl->calls);
+#if NANOVG_GL_USE_BATCHING
+	free(gl->vertFrags);
+	free(gl->indices);
+#endif
 
 	free(gl);
 }
@@ -1646,4 +2323,18 @@ GLuint nvglImageHandleGLES3(NVGcontext* ctx, int image)
 	return tex->tex;
 }
 
+#if defined NANOVG_GL2
+int nvglDrawCallsGL2(NVGcontext* ctx)
+#elif defined NANOVG_GL3
+int nvglDrawCallsGL3(NVGcontext* ctx)
+#elif defined NANOVG_GLES2
+int nvglDrawCallsGLES2(NVGcontext* ctx)
+#elif defined NANOVG_GLES3
+int nvglDrawCallsGLES3(NVGcontext* ctx)
+#endif
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	return gl->drawCalls;
+}
+
 #endif /* NANOVG_GL_IMPLEMENTATION */
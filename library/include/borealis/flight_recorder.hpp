@@ -0,0 +1,112 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <features/features_cpu.h>
+#include <stdint.h>
+
+#define BRLS_FLIGHT_RECORDER_EVENTS 2048 // must be a power of two
+#define BRLS_FLIGHT_RECORDER_FRAMES 1024 // must be a power of two
+#define BRLS_FLIGHT_RECORDER_TEXT 96
+
+#ifdef __SWITCH__
+#define BRLS_FLIGHT_RECORDER_PATH "sdmc:/borealis_flight.bin"
+#else
+#define BRLS_FLIGHT_RECORDER_PATH "borealis_flight.bin"
+#endif
+
+namespace brls
+{
+
+enum class FlightEventType : uint32_t
+{
+    LOG = 0, // value: log level, text: the line
+    FOCUS, // pointer: new focus, text: its type
+    VIEW_PUSH, // value: stack size after the push, pointer / text: the view
+    VIEW_POP, // value: stack size before the pop, pointer / text: the view
+    SLOW_FRAME, // value: frame interval (us), text: budget
+    CRASH, // text: the crash message
+    SIGNAL, // value: the signal number
+};
+
+// One event, written by memcpy-ing its fields - the sequence
+// number is stored last so that the decoder can tell torn records
+struct FlightEvent
+{
+    uint64_t sequence; // 1-based, 0 if never written
+    uint64_t timestamp; // us
+    uint32_t type;
+    uint32_t value;
+    uint64_t pointer;
+    char text[BRLS_FLIGHT_RECORDER_TEXT];
+};
+
+struct FlightFrame
+{
+    uint64_t timestamp; // start of the frame, us
+    uint32_t interval; // since the start of the previous frame, us
+    uint32_t work; // time spent running the frame, us
+};
+
+// Keeps the last events and frame timings in fixed-size
+// in-memory rings, to be dumped to a binary file after
+// a crash (see scripts/decode_flight_recorder.py)
+//
+// Recording never allocates nor formats
+class FlightRecorder
+{
+  public:
+    /**
+     * Records an event, text is truncated if needed and can be nullptr
+     * Can be called from any thread
+     */
+    static void record(FlightEventType type, uint32_t value, const void* pointer, const char* text);
+
+    /**
+     * Records the timings of the last frame, main thread only
+     */
+    static void recordFrame(retro_time_t start, retro_time_t interval, retro_time_t work);
+
+    /**
+     * Sets the path of the dump, copied to a fixed size buffer
+     */
+    static void setDumpPath(const char* path);
+
+    /**
+     * Returns the path of the dump
+     */
+    static const char* getDumpPath();
+
+    /**
+     * Writes both rings to the dump file, returns false on error
+     * Only uses async-signal-safe functions
+     */
+    static bool dump();
+
+    /**
+     * Dumps the recorder on SIGSEGV, SIGABRT, SIGFPE, SIGILL and SIGBUS,
+     * then gives the signal to the handler that was installed before
+     * (the default one if none) - call it after installing your own
+     * handlers (no-op on Switch)
+     */
+    static void installSignalHandlers();
+};
+
+} // namespace brls
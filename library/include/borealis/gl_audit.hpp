@@ -0,0 +1,73 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+
+namespace brls
+{
+
+// Debug layer counting the GL calls issued by every frame, by function,
+// and flagging the synchronous ones (glGet*, glGetError, glReadPixels, glFinish,
+// glClientWaitSync on a fence not signaled yet): they can make the CPU wait for
+// the GPU to catch up, and a steady frame should not issue any
+//
+// It works by swapping the glad function pointers for counting
+// wrappers, enabled at init with the BOREALIS_GL_AUDIT env variable
+class GLAudit
+{
+  public:
+    /**
+     * Wraps the GL functions, must be called
+     * once glad has loaded them
+     */
+    static void install();
+
+    static bool isInstalled();
+
+    /**
+     * Called by the main loop once the frame has been presented,
+     * makes its counts available and starts counting the next one
+     */
+    static void frame();
+
+    /**
+     * Returns the number of GL calls issued by the last frame
+     */
+    static unsigned getLastFrameCalls();
+
+    /**
+     * Returns the number of synchronous GL calls issued by the last frame
+     */
+    static unsigned getLastFrameSyncCalls();
+
+    /**
+     * Returns the number of calls to the given function
+     * in the last frame, or 0 if it's not audited
+     */
+    static unsigned getLastFrameCalls(const char* function);
+
+    /**
+     * Logs the calls of all frames so far, by function
+     */
+    static void logSummary();
+};
+
+} // namespace brls
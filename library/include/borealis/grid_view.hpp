@@ -0,0 +1,144 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <borealis/view.hpp>
+#include <functional>
+#include <vector>
+
+namespace brls
+{
+
+// A grid of fixed size cells, filled from a data source
+//
+// Only the cells of the visible rows (plus a few prefetched rows)
+// exist at any time: they are created by the factory the first time,
+// then recycled and given to the binder again as the grid scrolls
+//
+// Put it in a ScrollView to scroll it: the grid resizes itself
+// to fit all of its rows
+class GridView : public View
+{
+  public:
+    typedef std::function<View*(void)> CellFactory;
+    typedef std::function<void(View* cell, size_t index)> CellBinder;
+
+  private:
+    unsigned cellWidth;
+    unsigned cellHeight;
+    unsigned spacing      = 0;
+    unsigned prefetchRows = 1;
+
+    size_t itemsCount = 0;
+    CellFactory factory;
+    CellBinder binder;
+
+    size_t columns = 1;
+
+    // Cells of the items [firstIndex, firstIndex + cells.size())
+    size_t firstIndex = 0;
+    std::vector<View*> cells;
+    std::vector<View*> recycledCells;
+    std::vector<View*> cellsBuffer; // kept to avoid allocating on every layout
+
+    // Focused cell that went out of range, kept bound until the focus moves
+    // away so that it's not given to another item while it's still focused
+    View* pinnedCell = nullptr;
+
+    size_t focusedIndex = 0;
+
+    void recycleCell(View* cell);
+    View* obtainCell(size_t index);
+    void placeCell(View* cell, size_t index);
+
+    /**
+     * Materializes the cells of the visible rows, and
+     * the one of the given index if it's not visible
+     */
+    void updateCells(size_t requiredIndex);
+    void deleteCells();
+    void releasePinnedCell();
+    bool hasFocusedCell();
+    View* getFocusedCell();
+
+    /**
+     * Returns the visible rows range relative to the grid top, which is
+     * the one of the enclosing ScrollView if any, or the screen otherwise
+     */
+    void getViewport(int* top, int* bottom);
+
+    View* getCell(size_t index);
+    View* focusIndex(size_t index);
+
+  public:
+    GridView(unsigned cellWidth, unsigned cellHeight);
+    ~GridView();
+
+    void draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx) override;
+    void layout(NVGcontext* vg, Style* style, FontStash* stash) override;
+    View* getDefaultFocus() override;
+    View* getNextFocus(FocusDirection direction, View* currentView) override;
+    View* getNextPageFocus(FocusDirection direction, View* currentFocus) override;
+    void onChildFocusGained(View* child) override;
+    void willAppear(bool resetState = false) override;
+    void willDisappear(bool resetState = false) override;
+    void onWindowSizeChanged() override;
+
+    /**
+     * Sets the items count and the callbacks used
+     * to create cells and fill them for an item
+     */
+    void setDataSource(size_t itemsCount, CellFactory factory, CellBinder binder);
+
+    /**
+     * Changes the items count and binds
+     * the visible cells again
+     */
+    void setItemsCount(size_t itemsCount);
+    size_t getItemsCount();
+
+    /**
+     * Binds the visible cells again, to
+     * be called when items data changes
+     */
+    void reloadData();
+
+    /**
+     * Sets spacing between cells, both horizontally and vertically
+     */
+    void setSpacing(unsigned spacing);
+
+    /**
+     * Sets how many rows are materialized
+     * above and below the visible ones
+     */
+    void setPrefetchRows(unsigned rows);
+
+    size_t getColumnsCount();
+
+    /**
+     * Sets the focused item, giving it focus
+     * if the grid already has it
+     */
+    void setFocusedIndex(size_t index);
+    size_t getFocusedIndex();
+};
+
+} // namespace brls
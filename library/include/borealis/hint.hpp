@@ -22,6 +22,8 @@
 #include <borealis/box_layout.hpp>
 #include <borealis/label.hpp>
 #include <borealis/view.hpp>
+#include <string>
+#include <vector>
 
 namespace brls
 {
@@ -34,8 +36,11 @@ class Hint : public BoxLayout
   private:
     bool animate;
 
-    GenericEvent::Subscription globalFocusEventSubscriptor;
-    VoidEvent::Subscription globalHintsUpdateEventSubscriptor;
+    GenericEvent::ScopedSubscription globalFocusEventSubscriptor;
+    VoidEvent::ScopedSubscription globalHintsUpdateEventSubscriptor;
+
+    std::vector<std::string> hintsTexts; // text of every displayed label, in order
+    std::vector<Label*> labelsPool; // removed labels, kept to be reused
 
     static inline std::vector<Hint*> globalHintStack;
 
@@ -0,0 +1,101 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <features/features_cpu.h>
+
+#include <mutex>
+#include <vector>
+
+namespace brls
+{
+
+// A gamepad button press or release, as seen by the input sampler
+struct InputEvent
+{
+    int button; // GLFW_GAMEPAD_BUTTON_*
+    bool pressed;
+    retro_time_t timestamp; // Clock time, in microseconds
+};
+
+// Timing of the key repeat, for the last pressed button
+// The interval between repeats goes from startInterval to endInterval
+// over accelerationTime, following the given curve exponent
+// (1 is linear, higher values accelerate later)
+struct KeyRepeatCurve
+{
+    unsigned delay            = 250; // ms before the first repeat
+    unsigned startInterval    = 80; // ms
+    unsigned endInterval      = 30; // ms
+    unsigned accelerationTime = 2000; // ms
+    float exponent            = 2.0f;
+
+    /**
+     * Returns the interval before the next repeat, in microseconds,
+     * given how long the button has been repeating (in microseconds)
+     */
+    retro_time_t getInterval(retro_time_t repeatingTime) const;
+};
+
+// Samples the gamepad (or the keyboard as a fallback) and
+// turns state changes into timestamped events
+//
+// GLFW only allows polling input from the main thread, so sampling
+// happens there: every Application::setInputSamplingPeriod() (4ms by
+// default, longer while idle) as the main loop waits for the next frame,
+// and once more right before the frame is processed.
+// The queue itself is thread safe, events can be pushed from anywhere.
+class InputManager
+{
+  private:
+    GLFWwindow* window;
+
+    GLFWgamepadstate sampledState = {};
+
+    std::mutex eventsMutex;
+    std::vector<InputEvent> events;
+
+  public:
+    InputManager(GLFWwindow* window);
+
+    /**
+     * Reads the current gamepad state and queues an event
+     * for every button that changed since the last sample
+     *
+     * Must be called from the main thread
+     */
+    void sample();
+
+    /**
+     * Queues the given event
+     */
+    void pushEvent(InputEvent event);
+
+    /**
+     * Moves all queued events, oldest first, to the given vector
+     */
+    void drainEvents(std::vector<InputEvent>* events);
+
+    bool hasPendingEvents();
+};
+
+} // namespace brls
@@ -0,0 +1,118 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <features/features_cpu.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <borealis/input_manager.hpp>
+#include <string>
+#include <vector>
+
+namespace brls
+{
+
+// The gamepad state of one frame, as built by the main loop
+struct InputFrame
+{
+    int64_t time; // Clock time at the start of the frame, us
+    uint32_t buttons; // bit n set if GLFW_GAMEPAD_BUTTON n is pressed
+    uint32_t padding;
+};
+
+// Writes the gamepad state of every frame to a file,
+// to be replayed later by InputReplayer
+class InputRecorder
+{
+  private:
+    FILE* file      = nullptr;
+    uint64_t frames = 0;
+
+  public:
+    ~InputRecorder();
+
+    bool start(std::string path);
+    void stop();
+
+    bool isRecording();
+
+    /**
+     * Appends the state of the current frame
+     */
+    void recordFrame(retro_time_t time, GLFWgamepadstate* state);
+};
+
+// Feeds recorded gamepad states back to the input manager,
+// one frame at a time, and collects the frames statistics
+//
+// While replaying, the Clock follows the recorded timestamps:
+// animations, key repeats and timers see the same times as
+// during the recording, however long the frames actually take
+class InputReplayer
+{
+  private:
+    std::vector<InputFrame> frames;
+
+    // Index of the frame being replayed + 1, 0 before the first one
+    // Read by getTime(), which is the Clock source of any thread
+    std::atomic<size_t> current = 0;
+    uint32_t buttons            = 0; // state fed so far
+
+    std::vector<retro_time_t> frameTimes; // wall time of every replayed frame, us
+    uint64_t layouts   = 0;
+    uint64_t drawCalls = 0;
+
+  public:
+    bool load(std::string path);
+
+    bool isReplaying();
+    bool isFinished();
+
+    /**
+     * Moves on to the next recorded frame, returns false
+     * if there are no more frames to replay
+     */
+    bool nextFrame();
+
+    /**
+     * Queues events for the buttons that changed in the current frame
+     */
+    void pushEvents(InputManager* inputManager);
+
+    /**
+     * Returns the recorded time of the current frame, us
+     */
+    retro_time_t getTime();
+
+    size_t getFramesCount();
+
+    void recordFrameStats(retro_time_t frameTime, uint64_t layouts, uint64_t drawCalls);
+
+    /**
+     * Writes the statistics of the replayed frames as JSON
+     */
+    bool writeReport(std::string path);
+};
+
+} // namespace brls
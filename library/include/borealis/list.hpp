@@ -85,6 +85,11 @@ class ListItem : public View
 
     void setChecked(bool checked);
 
+    /**
+     * Sets the label of this list item, keeping
+     * the jump to letter index of its list up to date
+     */
+    void setLabel(std::string label);
     std::string getLabel();
 
     /**
@@ -185,6 +190,8 @@ class ListContentView : public BoxLayout
   public:
     ListContentView(List* list, size_t defaultFocus = 0);
 
+    List* getList();
+
   protected:
     void customSpacing(View* current, View* next, int* spacing) override;
 
@@ -201,12 +208,37 @@ class List : public ScrollView
   private:
     ListContentView* layout;
 
+    // First letter of every ListItem label, with its index
+    // sorted by letter then index - built when needed
+    std::vector<std::pair<char, size_t>> lettersIndex;
+    bool lettersIndexDirty = true;
+
+    void buildLettersIndex();
+    bool matchesLetter(size_t index, char letter); // is the item at index still starting with letter?
+
   public:
     List(size_t defaultFocus = 0);
     ~List();
 
+    /**
+     * Gives focus to the first item which label starts
+     * with the given letter, or the next letter if there is none
+     * Returns false if there is no such item
+     */
+    bool jumpToLetter(char letter);
+
+    /**
+     * Marks the letters index as outdated, to call
+     * when the label of an item changes
+     */
+    void invalidateLettersIndex();
+
     // Wrapped BoxLayout methods
     void addView(View* view, bool fill = false);
+    void addViews(const std::vector<View*>& views, bool fill = false);
+    void reserve(size_t count);
+    void setBuilderMode(bool builderMode);
+    bool jumpToIndex(size_t index);
     void setMargins(unsigned top, unsigned right, unsigned bottom, unsigned left);
     void setMarginBottom(unsigned bottom);
     void setSpacing(unsigned spacing);
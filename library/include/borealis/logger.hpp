@@ -21,8 +21,29 @@
 
 #include <stdarg.h>
 
+#include <atomic>
 #include <string>
 
+// Levels above this one are compiled out of the BRLS_LOG_* macros
+// 0 = errors only, 1 = info, 2 = debug
+#ifndef BRLS_LOG_MAX_LEVEL
+#define BRLS_LOG_MAX_LEVEL 2
+#endif
+
+#define BRLS_LOG_SUBSYSTEMS 6
+
+// Checks the level before evaluating the arguments
+#define BRLS_LOG(subsystem, level, ...)                                                      \
+    do                                                                                       \
+    {                                                                                        \
+        if ((int)(level) <= BRLS_LOG_MAX_LEVEL && brls::Logger::isEnabled(subsystem, level)) \
+            brls::Logger::write(subsystem, level, __VA_ARGS__);                              \
+    } while (0)
+
+#define BRLS_LOG_ERROR(subsystem, ...) BRLS_LOG(subsystem, brls::LogLevel::ERROR, __VA_ARGS__)
+#define BRLS_LOG_INFO(subsystem, ...) BRLS_LOG(subsystem, brls::LogLevel::INFO, __VA_ARGS__)
+#define BRLS_LOG_DEBUG(subsystem, ...) BRLS_LOG(subsystem, brls::LogLevel::DEBUG, __VA_ARGS__)
+
 namespace brls
 {
 
@@ -33,17 +54,71 @@ enum class LogLevel
     DEBUG
 };
 
+enum class LogSubsystem
+{
+    GENERAL = 0,
+    FOCUS,
+    VIEWS,
+    INPUT,
+    TASKS,
+    RENDER
+};
+
+// Lines are formatted by the calling thread into a lock-free
+// ring buffer, and written to stdout by a background thread
+//
+// When the buffer is full, lines are dropped (and counted)
+// instead of blocking the caller
 class Logger
 {
   public:
+    /**
+     * Sets the level of every subsystem
+     */
     static void setLogLevel(LogLevel logLevel);
+    static void setLogLevel(LogSubsystem subsystem, LogLevel logLevel);
+
+    static inline bool isEnabled(LogSubsystem subsystem, LogLevel logLevel)
+    {
+        return Logger::levels[(int)subsystem].load(std::memory_order_relaxed) >= logLevel;
+    }
 
     static void error(const char* format, ...);
     static void info(const char* format, ...);
     static void debug(const char* format, ...);
 
+    /**
+     * Queues the line without checking the level,
+     * use the BRLS_LOG_* macros instead
+     */
+    static void write(LogSubsystem subsystem, LogLevel logLevel, const char* format, ...);
+
+    /**
+     * Writes every queued line from the calling thread
+     *
+     * Application::exit() calls it once everything is stopped,
+     * the logger itself stays alive until the process exits
+     */
+    static void flush();
+
+    /**
+     * Returns the number of lines dropped because
+     * the buffer was full
+     */
+    static size_t getDroppedLines();
+
   protected:
-    static void log(LogLevel logLevel, const char* prefix, const char* color, const char* format, va_list ap);
+    static void log(LogSubsystem subsystem, LogLevel logLevel, const char* format, va_list ap);
+
+  private:
+    inline static std::atomic<LogLevel> levels[BRLS_LOG_SUBSYSTEMS] = {
+        LogLevel::INFO,
+        LogLevel::INFO,
+        LogLevel::INFO,
+        LogLevel::INFO,
+        LogLevel::INFO,
+        LogLevel::INFO,
+    };
 };
 
 } // namespace brls
@@ -0,0 +1,78 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <features/features_cpu.h>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+
+namespace brls
+{
+
+// Closures posted by any thread, run by the main thread
+//
+// Producers only do an atomic exchange (Vyukov's intrusive MPSC
+// queue), everything else (coalescing, time budget) happens on
+// the consumer side
+class MainThreadQueue
+{
+  private:
+    struct Node
+    {
+        std::atomic<Node*> next;
+        std::function<void(void)> work;
+        const void* key;
+    };
+
+    std::atomic<Node*> head; // last pushed node, producers side
+    Node* tail; // next node to pop, consumer side
+    Node stub;
+
+    std::deque<Node*> pending; // popped but not run yet
+
+    void pushNode(Node* node);
+    Node* pop();
+
+  public:
+    MainThreadQueue();
+    ~MainThreadQueue();
+
+    /**
+      * Posts the closure, can be called from any thread
+      *
+      * If a key is given, only the latest closure posted with
+      * that key still waiting to run will be executed
+      */
+    void push(std::function<void(void)> work, const void* key = nullptr);
+
+    /**
+      * Runs the posted closures in order, until the queue is empty
+      * or the budget (in us) is exhausted - at least one closure
+      * runs every call, the others are kept for the next one
+      *
+      * Must be called by the main thread, returns the number
+      * of closures run
+      */
+    size_t dispatch(retro_time_t budget);
+};
+
+} // namespace brls
@@ -38,7 +38,7 @@ class Notification : public View
     void draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx) override;
     void layout(NVGcontext* vg, Style* style, FontStash* stash) override;
 
-    menu_timer_t timeoutTimer;
+    menu_timer_t timeoutTimer = 0;
 
   private:
     Label* label;
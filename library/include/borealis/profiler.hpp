@@ -0,0 +1,107 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <features/features_cpu.h>
+
+#include <atomic>
+#include <string>
+
+#define BRLS_PROFILE_CONCAT_INNER(a, b) a##b
+#define BRLS_PROFILE_CONCAT(a, b) BRLS_PROFILE_CONCAT_INNER(a, b)
+
+// Records the duration of the enclosing scope under the given name
+// A single branch when the profiler is stopped, and nothing
+// at all when compiled with BRLS_NO_PROFILING
+//
+// name and detail must outlive the profiler (string literals,
+// typeid names...) - mangled type names are demangled when
+// the trace is written
+#ifdef BRLS_NO_PROFILING
+#define BRLS_PROFILE_SCOPE(name)
+#define BRLS_PROFILE_SCOPE_DETAIL(name, detail)
+#else
+#define BRLS_PROFILE_SCOPE(name) brls::ProfileScope BRLS_PROFILE_CONCAT(profileScope, __LINE__)(name, nullptr)
+#define BRLS_PROFILE_SCOPE_DETAIL(name, detail) brls::ProfileScope BRLS_PROFILE_CONCAT(profileScope, __LINE__)(name, detail)
+#endif
+
+namespace brls
+{
+
+// Collects profiling zones into per-thread buffers and writes
+// them as Chrome trace-event JSON, to be opened in Perfetto
+// or chrome://tracing
+//
+// Started by Application::init() if the BOREALIS_TRACE env
+// variable is set to the output path, and written on exit
+class Profiler
+{
+  public:
+    /**
+     * Starts recording, the trace will be written to the given path
+     */
+    static void start(std::string path);
+
+    /**
+     * Stops recording and writes the trace - other threads
+     * must not be recording zones anymore
+     * Returns false if the file could not be written
+     */
+    static bool stop();
+
+    static inline bool isEnabled()
+    {
+        return Profiler::enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Names the calling thread in the trace
+     */
+    static void setThreadName(std::string name);
+
+    static void record(const char* name, const char* detail, retro_time_t start, retro_time_t end);
+
+  private:
+    inline static std::atomic<bool> enabled = false; // read from every thread
+};
+
+class ProfileScope
+{
+  private:
+    const char* name;
+    const char* detail;
+    retro_time_t start;
+
+  public:
+    ProfileScope(const char* name, const char* detail)
+        : name(name)
+        , detail(detail)
+        , start(Profiler::isEnabled() ? cpu_features_get_time_usec() : 0)
+    {
+    }
+
+    ~ProfileScope()
+    {
+        if (this->start != 0 && Profiler::isEnabled())
+            Profiler::record(this->name, this->detail, this->start, cpu_features_get_time_usec());
+    }
+};
+
+} // namespace brls
@@ -22,6 +22,7 @@
 #include <borealis/label.hpp>
 #include <borealis/progress_spinner.hpp>
 #include <borealis/view.hpp>
+#include <atomic>
 
 namespace brls
 {
@@ -30,11 +31,32 @@ namespace brls
 enum ProgressDisplayFlags
 {
     SPINNER    = 1u << 0,
-    PERCENTAGE = 1u << 1
+    PERCENTAGE = 1u << 1,
+    THROUGHPUT = 1u << 2, // bytes per second, needs a ProgressSource
+    ETA        = 1u << 3, // needs a ProgressSource
 };
 
 inline constexpr ProgressDisplayFlags DEFAULT_PROGRESS_DISPLAY_FLAGS = (ProgressDisplayFlags)(ProgressDisplayFlags::SPINNER | ProgressDisplayFlags::PERCENTAGE);
 
+// Progress published by a worker thread, without locks nor allocations,
+// and sampled by the ProgressDisplays it's attached to once per frame
+class ProgressSource
+{
+  private:
+    std::atomic<uint64_t> current;
+    std::atomic<uint64_t> total;
+
+  public:
+    ProgressSource(uint64_t total = 100);
+
+    void setTotal(uint64_t total);
+    void setProgress(uint64_t current);
+    void advance(uint64_t delta);
+
+    uint64_t getProgress();
+    uint64_t getTotal();
+};
+
 // A progress bar with an optional spinner and percentage text.
 class ProgressDisplay : public View
 {
@@ -49,10 +71,44 @@ class ProgressDisplay : public View
 
     void setProgress(int current, int max);
 
+    /**
+      * Follows the given source instead of setProgress(),
+      * nullptr to detach - the source is not owned
+      */
+    void setSource(ProgressSource* source);
+
+    /**
+      * Returns the smoothed throughput of the source in units
+      * per second, or 0 if not known yet
+      */
+    float getThroughput();
+
+    /**
+      * Returns the estimated remaining time in seconds,
+      * or -1 if not known yet
+      */
+    int getETA();
+
   private:
     float progressPercentage = 0.0f;
-    Label* label;
-    ProgressSpinner* spinner;
+    int displayedPercentage  = -1;
+
+    Label* label             = nullptr;
+    Label* readoutLabel      = nullptr; // throughput and ETA
+    ProgressSpinner* spinner = nullptr;
+
+    ProgressDisplayFlags flags;
+
+    ProgressSource* source = nullptr;
+
+    // Throughput measurement window
+    retro_time_t windowStart = 0;
+    uint64_t windowProgress  = 0;
+    float throughput         = 0.0f;
+
+    void updatePercentage(uint64_t current, uint64_t max);
+    void sampleSource();
+    void updateReadout();
 };
 
 } // namespace brls
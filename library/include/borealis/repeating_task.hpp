@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <borealis/timer_scheduler.hpp>
 #include <features/features_cpu.h>
 
 namespace brls
@@ -36,6 +37,10 @@ class RepeatingTask
     bool running       = false;
     bool stopRequested = false;
 
+    TimerId timer = 0; // next run, if scheduled
+
+    friend class TaskManager;
+
   public:
     RepeatingTask(retro_time_t interval);
     virtual ~RepeatingTask();
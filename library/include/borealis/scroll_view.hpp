@@ -56,6 +56,7 @@ class ScrollView : public View
     void willDisappear(bool resetState = false) override;
     View* getDefaultFocus() override;
     void onChildFocusGained(View* child) override;
+    View* getNextPageFocus(FocusDirection direction, View* currentFocus) override;
     void onWindowSizeChanged() override;
 
     void setContentView(View* view);
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <borealis/repeating_task.hpp>
+#include <borealis/timer_scheduler.hpp>
 #include <vector>
 
 namespace brls
@@ -29,6 +30,9 @@ class TaskManager
 {
   private:
     std::vector<RepeatingTask*> repeatingTasks;
+    std::vector<RepeatingTask*> stoppedTasks; // deleted at the beginning of the next frame
+
+    TimerScheduler timers;
 
     void stopRepeatingTask(RepeatingTask* task);
 
@@ -37,6 +41,30 @@ class TaskManager
 
     void registerRepeatingTask(RepeatingTask* task);
 
+    /**
+      * (Re)schedules the next run of the task, interval
+      * ms after its last run
+      */
+    void scheduleRepeatingTask(RepeatingTask* task);
+    void unscheduleRepeatingTask(RepeatingTask* task);
+
+    /**
+      * Deletes the task at the beginning of the next frame
+      */
+    void requestStop(RepeatingTask* task);
+
+    /**
+      * The scheduler running the repeating tasks and
+      * the menu_timer_* timers
+      */
+    TimerScheduler* getTimerScheduler();
+
+    /**
+      * Returns the time (in ms) of the next timer or
+      * repeating task run, or -1 if there is none
+      */
+    retro_time_t getNextDeadline();
+
     ~TaskManager();
 };
 
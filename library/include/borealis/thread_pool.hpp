@@ -0,0 +1,170 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace brls
+{
+
+enum class TaskPriority
+{
+    HIGH = 0,
+    NORMAL,
+    LOW,
+};
+
+#define BRLS_TASK_PRIORITIES 3
+
+enum class TaskStatus
+{
+    PENDING = 0,
+    RUNNING,
+    DONE,
+    CANCELLED, // cancelled before it could start
+};
+
+// Shared state of a task submitted to a ThreadPool
+struct PoolTask
+{
+    std::function<void(void)> work;
+    std::function<void(void)> completion;
+
+    std::atomic<TaskStatus> status;
+    std::atomic<bool> cancelRequested;
+
+    std::mutex mutex;
+    std::condition_variable doneCondition;
+};
+
+// Handle to a task submitted to a ThreadPool
+class TaskHandle
+{
+  private:
+    std::shared_ptr<PoolTask> task;
+
+  public:
+    TaskHandle() = default;
+    TaskHandle(std::shared_ptr<PoolTask> task);
+
+    /**
+     * Cancels the task: it will not start if it's still
+     * pending, and its completion will not be called
+     * Returns true if the task was cancelled before starting
+     */
+    bool cancel();
+
+    bool isCancelled();
+
+    /**
+     * Returns true once the work is finished (or cancelled before starting)
+     * The completion may not have been called yet
+     */
+    bool isDone();
+
+    /**
+     * Blocks until the work is finished or cancelled
+     */
+    void wait();
+
+    TaskStatus getStatus();
+
+    bool isValid();
+};
+
+// A pool of worker threads for heavy work (file hashing,
+// decompression, directory scans...)
+//
+// Every worker has its own queues (one per priority) and steals
+// tasks from the others when it runs out of work. Work functions
+// must not touch views: use the completion, which is called on the
+// UI thread during TaskManager::frame() once the work is done.
+class ThreadPool
+{
+  private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<PoolTask>> queues[BRLS_TASK_PRIORITIES];
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<unsigned> nextWorker;
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::atomic<size_t> pendingTasks;
+    std::atomic<bool> stopping;
+
+    std::mutex completionsMutex;
+    std::vector<std::shared_ptr<PoolTask>> completions;
+    std::vector<std::shared_ptr<PoolTask>> completionsBuffer;
+
+    inline static thread_local ThreadPool* currentPool = nullptr;
+    inline static thread_local unsigned currentWorker  = 0;
+    inline static thread_local PoolTask* currentTask   = nullptr;
+
+    void workerMain(unsigned index);
+    std::shared_ptr<PoolTask> takeTask(unsigned index);
+    void runTask(std::shared_ptr<PoolTask> task);
+
+  public:
+    /**
+     * Starts the given count of workers, or one less
+     * than the CPU cores count if 0 (at least one)
+     */
+    ThreadPool(unsigned threadsCount = 0);
+
+    /**
+     * Stops the workers once their current task is done,
+     * pending tasks are cancelled
+     */
+    ~ThreadPool();
+
+    /**
+     * Queues the given work, returning a handle to it
+     * The completion is called on the UI thread once the work is done
+     */
+    TaskHandle submit(std::function<void(void)> work, std::function<void(void)> completion = nullptr, TaskPriority priority = TaskPriority::NORMAL);
+
+    /**
+     * Calls the completions of the finished tasks
+     * Called by TaskManager::frame() on the UI thread
+     */
+    void dispatchCompletions();
+
+    unsigned getThreadsCount();
+
+    /**
+     * Returns true if the task running on the calling worker
+     * has been cancelled - long work can poll it to stop early
+     */
+    static bool isCurrentTaskCancelled();
+};
+
+} // namespace brls
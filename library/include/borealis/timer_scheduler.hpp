@@ -0,0 +1,102 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <features/features_cpu.h>
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace brls
+{
+
+typedef uint64_t TimerId; // 0 is never a valid timer
+typedef std::function<void(void)> TimerCallback;
+
+// One-shot timers ordered by deadline in a min-heap, so that
+// a frame only looks at the timers that are due
+//
+// Cancelled timers stay in the heap and are skipped when they
+// reach the top, the heap is compacted if too many of them pile up
+class TimerScheduler
+{
+  private:
+    struct Timer
+    {
+        retro_time_t deadline;
+        TimerId id;
+
+        bool operator>(const Timer& other) const
+        {
+            // Timers with the same deadline fire in scheduling order
+            return this->deadline != other.deadline ? this->deadline > other.deadline : this->id > other.id;
+        }
+    };
+
+    std::vector<Timer> heap;
+    std::unordered_map<TimerId, TimerCallback> callbacks; // scheduled timers only
+
+    TimerId nextId = 1;
+
+    void popCancelled();
+    void compact();
+
+  public:
+    /**
+      * Schedules the callback to run once, at the first
+      * frame after the given deadline (in ms)
+      */
+    TimerId scheduleAt(retro_time_t deadline, TimerCallback callback);
+
+    /**
+      * Schedules the callback to run once, in delay ms
+      */
+    TimerId schedule(retro_time_t delay, TimerCallback callback);
+
+    /**
+      * Cancels the given timer, does nothing if it
+      * already fired or was cancelled
+      */
+    void cancel(TimerId id);
+
+    bool isScheduled(TimerId id);
+
+    /**
+      * Runs the callbacks of every timer due at the given time
+      * Timers scheduled by these callbacks with a deadline
+      * in the past wait for the next call
+      */
+    void fire(retro_time_t currentTime);
+
+    /**
+      * Returns the deadline of the next timer, or -1 if there is none
+      */
+    retro_time_t getNextDeadline();
+
+    size_t getTimersCount();
+
+    /**
+      * Cancels all timers
+      */
+    void clear();
+};
+
+} // namespace brls
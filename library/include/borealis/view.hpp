@@ -104,10 +104,12 @@ class View
     std::vector<Action> actions;
 
     /**
-     * Parent user data, typically the index of the view
-     * in the internal layout structure
+     * Index of the view in its parent
+     * children, maintained by layouts
      */
-    void* parentUserdata = nullptr;
+    size_t parentIndex = 0;
+
+    bool onFocusPath = false; // maintained by the action table
 
   protected:
     int x = 0;
@@ -194,11 +196,12 @@ class View
 
     void setForceTranslucent(bool translucent);
 
-    void setParent(View* parent, void* parentUserdata = nullptr);
+    void setParent(View* parent, size_t parentIndex = 0);
     View* getParent();
     bool hasParent();
 
-    void* getParentUserData();
+    void setParentIndex(size_t parentIndex);
+    size_t getParentIndex();
 
     void registerAction(std::string hintText, Key key, ActionListener actionListener, bool hidden = false);
     void updateActionHint(Key key, std::string hintText);
@@ -320,6 +323,13 @@ class View
 
     bool isFocused();
 
+    /**
+     * Returns true if the view is the focused view or one of its
+     * ancestors, as of the last action table build
+     */
+    bool isOnFocusPath();
+    void setOnFocusPath(bool onFocusPath);
+
     /**
      * Returns the default view to focus when focusing this view
      * Typically the view itself or one of its children
@@ -340,13 +350,25 @@ class View
 
     /**
      * Returns the next view to focus given the requested direction
-     * and the currently focused view (as parent user data)
+     * and the current view (our child containing the focused view)
      *
      * Returning nullptr means that there is no next view to focus
      * in that direction - getNextFocus will then be called on our
      * parent if any
      */
-    virtual View* getNextFocus(FocusDirection direction, void* parentUserdata)
+    virtual View* getNextFocus(FocusDirection direction, View* currentView)
+    {
+        return nullptr;
+    }
+
+    /**
+     * Returns the view to focus one page away from the currently
+     * focused view (one of our descendants) in the given direction
+     *
+     * Returning nullptr means that this view cannot page - it
+     * will then be asked to our parent if any
+     */
+    virtual View* getNextPageFocus(FocusDirection direction, View* currentFocus)
     {
         return nullptr;
     }
@@ -379,6 +401,29 @@ class View
             this->getParent()->onChildFocusLost(this);
     }
 
+    /**
+     * Must be called by views when getDefaultFocus() may have
+     * changed from or to nullptr, so that the parent can update
+     * its focus index (collapse and expand do it already)
+     */
+    void notifyFocusabilityChanged()
+    {
+        if (this->hasParent())
+            this->getParent()->onChildFocusabilityChanged(this);
+    }
+
+    /**
+     * Fired when one of this view's children may have
+     * become focusable or unfocusable
+     *
+     * By default the focusability of a view depends on its
+     * children (frames, scroll views...), so it's forwarded up
+     */
+    virtual void onChildFocusabilityChanged(View* child)
+    {
+        this->notifyFocusabilityChanged();
+    }
+
     /**
      * Fired when the window size changes
      * Not guaranteed to be called before or after layout()
@@ -400,6 +445,13 @@ class View
       */
     void overrideThemeVariant(ThemeValues* newTheme);
 
+    /**
+      * Views are allocated from the current
+      * ViewArena if there is one, see view_arena.hpp
+      */
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr);
+
     virtual ~View();
 };
 
@@ -0,0 +1,126 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <stddef.h>
+
+#include <vector>
+
+namespace brls
+{
+
+class View;
+
+// Allocation statistics of a view arena
+struct ViewArenaStats
+{
+    size_t allocations     = 0; // since the arena creation
+    size_t liveAllocations = 0;
+    size_t bytesAllocated  = 0; // since the arena creation
+    size_t liveBytes       = 0;
+    size_t bytesReserved   = 0; // total size of the blocks
+    size_t blocks          = 0;
+
+    /**
+     * Returns the share of the reserved bytes that
+     * are not used by live allocations (0 to 1)
+     */
+    float getFragmentation() const;
+};
+
+// An opt-in bump allocator for the views of one activity
+//
+// While a ViewArenaScope is active on a thread, every view created
+// on that thread is allocated from its arena. Deleting those views
+// still runs their destructors, but does not give memory back: the
+// arena blocks are all freed at once when the arena has been
+// released and its last view has been deleted.
+//
+// Arenas are reference counted and start with one reference, owned by
+// their creator who must release it once done creating views. Pushing
+// a view allocated from an arena takes another reference, released
+// by the application once the view is popped.
+//
+// Arenas are not thread safe: create and delete their views on the
+// same thread (usually the main one). Views allocated outside of any
+// arena can be created and deleted from any thread.
+class ViewArena
+{
+  private:
+    size_t blockSize;
+
+    std::vector<char*> blocks;
+    size_t blockOffset   = 0; // in the last block
+    size_t blockCapacity = 0; // of the last block
+
+    unsigned references = 1;
+
+    ViewArenaStats stats;
+
+    inline static thread_local ViewArena* current = nullptr;
+
+    ~ViewArena();
+
+    void* allocate(size_t size);
+    void deallocate(size_t size);
+
+    friend class ViewArenaScope;
+
+  public:
+    ViewArena(size_t blockSize = 64 * 1024);
+
+    void retain();
+    void release();
+
+    ViewArenaStats getStats();
+
+    /**
+     * Returns the arena used for new views on
+     * the calling thread, if any
+     */
+    static ViewArena* getCurrent();
+
+    /**
+     * Returns the arena the given view was allocated from, if any
+     */
+    static ViewArena* getArena(View* view);
+
+    /**
+     * Statistics of the views allocated outside of any arena
+     */
+    static ViewArenaStats getHeapStats();
+
+    // Used by View::operator new and View::operator delete
+    static void* allocateView(size_t size);
+    static void deallocateView(void* ptr);
+};
+
+// Makes an arena the current one on this thread until destroyed
+class ViewArenaScope
+{
+  private:
+    ViewArena* previous;
+
+  public:
+    ViewArenaScope(ViewArena* arena);
+    ~ViewArenaScope();
+};
+
+} // namespace brls
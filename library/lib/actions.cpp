@@ -0,0 +1,125 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  WerWolv
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <borealis/actions.hpp>
+#include <borealis/view.hpp>
+
+namespace brls
+{
+
+const Action& ActionRef::get() const
+{
+    return this->view->getActions()[this->index];
+}
+
+ActionTable::ActionTable(bool flagsFocusPath)
+    : flagsFocusPath(flagsFocusPath)
+{
+}
+
+void ActionTable::build(View* focus)
+{
+    // Destroyed views have already been removed
+    if (this->flagsFocusPath)
+    {
+        for (View* view : this->focusPath)
+            view->setOnFocusPath(false);
+    }
+
+    this->focusPath.clear();
+    this->actions.clear();
+    this->availableKeys.reset();
+    this->keysOffsets.fill(0);
+
+    // Collect all actions and count them by key
+    for (View* view = focus; view != nullptr; view = view->getParent())
+    {
+        this->focusPath.push_back(view);
+
+        if (this->flagsFocusPath)
+            view->setOnFocusPath(true);
+
+        const std::vector<Action>& viewActions = view->getActions();
+
+        for (size_t i = 0; i < viewActions.size(); i++)
+        {
+            size_t key = (size_t)viewActions[i].key;
+
+            this->actions.push_back({ view, i });
+            this->keysOffsets[key + 1]++;
+
+            if (viewActions[i].available)
+                this->availableKeys.set(key);
+        }
+    }
+
+    // Group them by key, keeping the focus path order
+    for (size_t key = 0; key < BRLS_KEYS_COUNT; key++)
+        this->keysOffsets[key + 1] += this->keysOffsets[key];
+
+    std::array<size_t, BRLS_KEYS_COUNT + 1> cursors = this->keysOffsets;
+    this->actionsByKey.resize(this->actions.size());
+
+    for (const ActionRef& ref : this->actions)
+        this->actionsByKey[cursors[(size_t)ref.get().key]++] = ref;
+}
+
+const ActionRef* ActionTable::getActions(Key key, size_t* count)
+{
+    size_t index = (size_t)key;
+
+    *count = this->keysOffsets[index + 1] - this->keysOffsets[index];
+    return this->actionsByKey.data() + this->keysOffsets[index];
+}
+
+const std::vector<ActionRef>& ActionTable::getActions()
+{
+    return this->actions;
+}
+
+bool ActionTable::hasAvailableAction(Key key)
+{
+    return this->availableKeys.test((size_t)key);
+}
+
+const std::vector<View*>& ActionTable::getFocusPath()
+{
+    return this->focusPath;
+}
+
+bool ActionTable::isOnFocusPath(View* view)
+{
+    if (this->flagsFocusPath)
+        return view->isOnFocusPath();
+
+    return std::find(this->focusPath.begin(), this->focusPath.end(), view) != this->focusPath.end();
+}
+
+void ActionTable::remove(View* view)
+{
+    auto it = std::find(this->focusPath.begin(), this->focusPath.end(), view);
+
+    if (it != this->focusPath.end())
+        this->focusPath.erase(it);
+
+    if (this->flagsFocusPath)
+        view->setOnFocusPath(false);
+}
+
+} // namespace brls
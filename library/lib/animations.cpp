@@ -29,6 +29,8 @@
 #include <string/stdstring.h>
 
 #include <borealis/animations.hpp>
+#include <borealis/application.hpp>
+#include <borealis/clock.hpp>
 #include <vector>
 
 namespace brls
@@ -401,35 +403,17 @@ void menu_animation_free(void)
     anim.pending_deletes = false;
 }
 
-static void menu_delayed_animation_cb(void* userdata)
-{
-    menu_delayed_animation_t* delayed_animation = (menu_delayed_animation_t*)userdata;
-
-    menu_animation_push(&delayed_animation->entry);
-
-    free(delayed_animation);
-}
-
 void menu_animation_push_delayed(unsigned delay, menu_animation_ctx_entry_t* entry)
 {
-    menu_timer_ctx_entry_t timer_entry;
-    menu_delayed_animation_t* delayed_animation = (menu_delayed_animation_t*)malloc(sizeof(menu_delayed_animation_t));
-
-    delayed_animation->entry.cb           = entry->cb;
-    delayed_animation->entry.duration     = entry->duration;
-    delayed_animation->entry.easing_enum  = entry->easing_enum;
-    delayed_animation->entry.subject      = entry->subject;
-    delayed_animation->entry.tag          = entry->tag;
-    delayed_animation->entry.target_value = entry->target_value;
-    delayed_animation->entry.tick         = entry->tick;
-    delayed_animation->entry.userdata     = entry->userdata;
+    // The entry is kept by the timer callback itself, so that it's
+    // freed along with the timer if it never fires (cleared at exit)
+    menu_animation_ctx_entry_t delayedEntry = *entry;
 
-    timer_entry.cb       = menu_delayed_animation_cb;
-    timer_entry.tick     = NULL;
-    timer_entry.duration = delay;
-    timer_entry.userdata = delayed_animation;
-
-    menu_timer_start(&delayed_animation->timer, &timer_entry);
+    Application::getTaskManager()->getTimerScheduler()->schedule(
+        (retro_time_t)delay,
+        [delayedEntry]() mutable {
+            menu_animation_push(&delayedEntry);
+        });
 }
 
 bool menu_animation_push(menu_animation_ctx_entry_t* entry)
@@ -604,7 +588,7 @@ static void menu_animation_update_time(bool timedate_enable)
     unsigned ticker_speed      = (unsigned)(((float)TICKER_SPEED / speed_factor) + 0.5);
     unsigned ticker_slow_speed = (unsigned)(((float)TICKER_SLOW_SPEED / speed_factor) + 0.5);
 
-    cur_time   = cpu_features_get_time_usec() / 1000;
+    cur_time   = Clock::getTimeMs();
     delta_time = old_time == 0 ? 0 : cur_time - old_time;
 
     old_time = cur_time;
@@ -637,6 +621,8 @@ static void menu_animation_update_time(bool timedate_enable)
 
 bool menu_animation_update(void)
 {
+    BRLS_PROFILE_SCOPE("menu_animation_update");
+
     unsigned i;
 
     menu_animation_update_time(false);
@@ -895,29 +881,28 @@ bool menu_animation_ctl(enum menu_animation_ctl_state state, void* data)
 
 void menu_timer_start(menu_timer_t* timer, menu_timer_ctx_entry_t* timer_entry)
 {
-    menu_animation_ctx_entry_t entry;
-    menu_animation_ctx_tag tag = (uintptr_t)timer;
-
     menu_timer_kill(timer);
 
-    *timer = 0.0f;
+    // The timer storage may be freed by the callback,
+    // so don't touch it once the timer fired: ids are never reused
+    tween_cb cb    = timer_entry->cb;
+    void* userdata = timer_entry->userdata;
 
-    entry.easing_enum  = EASING_LINEAR;
-    entry.tag          = tag;
-    entry.duration     = timer_entry->duration;
-    entry.target_value = 1.0f;
-    entry.subject      = timer;
-    entry.cb           = timer_entry->cb;
-    entry.tick         = timer_entry->tick;
-    entry.userdata     = timer_entry->userdata;
-
-    menu_animation_push(&entry);
+    *timer = Application::getTaskManager()->getTimerScheduler()->schedule(
+        (retro_time_t)timer_entry->duration,
+        [cb, userdata]() {
+            if (cb)
+                cb(userdata);
+        });
 }
 
 void menu_timer_kill(menu_timer_t* timer)
 {
-    menu_animation_ctx_tag tag = (uintptr_t)timer;
-    menu_animation_kill_by_tag(&tag);
+    if (*timer == 0)
+        return;
+
+    Application::getTaskManager()->getTimerScheduler()->cancel(*timer);
+    *timer = 0;
 }
 
 uint64_t menu_animation_get_ticker_idx(void)
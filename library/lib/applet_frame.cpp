@@ -232,6 +232,7 @@ void AppletFrame::setContentView(View* view)
         this->contentView->willAppear();
     }
 
+    this->notifyFocusabilityChanged();
     this->invalidate();
 }
 
@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <borealis.hpp>
 #include <string>
+#include <typeinfo>
 
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
@@ -41,14 +42,13 @@
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 #define NANOVG_GL3_IMPLEMENTATION
+#define NANOVG_GL_HAS_BUFFER_STORAGE GLAD_GL_ARB_buffer_storage
 #include <nanovg_gl.h>
 
 #ifdef __SWITCH__
 #include <switch.h>
 #endif
 
-#include <chrono>
-#include <set>
 #include <thread>
 
 // Constants used for scaling as well as
@@ -57,8 +57,9 @@ constexpr uint32_t WINDOW_WIDTH  = 1280;
 constexpr uint32_t WINDOW_HEIGHT = 720;
 
 #define DEFAULT_FPS 60
-#define BUTTON_REPEAT_DELAY 15
-#define BUTTON_REPEAT_CADENCY 5
+#define MAX_REPEATS_PER_FRAME 4
+#define IDLE_SAMPLING_PERIOD 16000 // usec
+#define IDLE_MAX_SLEEP 250000 // usec
 
 // glfw code from the glfw hybrid app by fincs
 // https://github.com/fincs/hybrid_app
@@ -66,7 +67,6 @@ constexpr uint32_t WINDOW_HEIGHT = 720;
 namespace brls
 {
 
-// TODO: Use this instead of a glViewport each frame
 static void windowFramebufferSizeCallback(GLFWwindow* window, int width, int height)
 {
     if (!width || !height)
@@ -81,6 +81,7 @@ static void windowFramebufferSizeCallback(GLFWwindow* window, int width, int hei
     Application::contentHeight = (unsigned)roundf(contentHeight);
 
     Application::resizeNotificationManager();
+    Application::setWindowSize(width, height);
 
     Logger::info("Window size changed to %dx%d", width, height);
     Logger::info("New scale factor is %f", Application::windowScale);
@@ -139,17 +140,50 @@ bool Application::init(std::string title)
 
 bool Application::init(std::string title, Style style, Theme theme)
 {
-    // Init rng
-    std::srand(std::time(nullptr));
+    Application::mainThreadId = std::this_thread::get_id();
+
+    FlightRecorder::installSignalHandlers();
+
+    // Start the profiler
+    char* traceEnv = getenv("BOREALIS_TRACE");
+    if (traceEnv != nullptr && traceEnv[0] != '\0')
+    {
+        Profiler::start(traceEnv);
+        Profiler::setThreadName("main");
+    }
+
+    // Init clock
+    char* virtualClockEnv = getenv("BOREALIS_VIRTUAL_CLOCK");
+    if (virtualClockEnv != nullptr && atof(virtualClockEnv) > 0.0f)
+        Clock::setVirtual(atof(virtualClockEnv));
+
+    // Inputs recording and replay
+    char* headlessEnv = getenv("BOREALIS_HEADLESS");
+    if (headlessEnv != nullptr && atoi(headlessEnv) != 0)
+        Application::setHeadless(true);
+
+    char* recordInputEnv = getenv("BOREALIS_RECORD_INPUT");
+    if (recordInputEnv != nullptr && recordInputEnv[0] != '\0')
+        Application::recordInputs(recordInputEnv);
+
+    char* replayInputEnv = getenv("BOREALIS_REPLAY_INPUT");
+    if (replayInputEnv != nullptr && replayInputEnv[0] != '\0')
+    {
+        char* replayReportEnv = getenv("BOREALIS_REPLAY_REPORT");
+        Application::replayInputs(replayInputEnv, replayReportEnv ? replayReportEnv : "");
+    }
+
+    // Init rng - use a fixed seed with the virtual clock or a replay to keep runs identical
+    std::srand(Clock::isVirtual() || Application::isReplayingInputs() ? 0 : std::time(nullptr));
 
     // Init managers
     Application::taskManager         = new TaskManager();
+    Application::threadPool          = new ThreadPool();
     Application::notificationManager = new NotificationManager();
 
     // Init static variables
     Application::currentStyle = style;
     Application::currentFocus = nullptr;
-    Application::oldGamepad   = {};
     Application::gamepad      = {};
     Application::title        = title;
 
@@ -180,6 +214,9 @@ bool Application::init(std::string title, Style style, Theme theme)
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 #endif
 
+    if (Application::headless)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
     Application::window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, title.c_str(), nullptr, nullptr);
     if (!window)
     {
@@ -195,9 +232,17 @@ bool Application::init(std::string title, Style style, Theme theme)
     glfwSetKeyCallback(window, windowKeyCallback);
     glfwSetJoystickCallback(joystickCallback);
 
+    Application::inputManager = new InputManager(window);
+
     // Load OpenGL routines using glad
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
-    glfwSwapInterval(1);
+
+    // Count the GL calls of every frame if asked to
+    char* glAuditEnv = getenv("BOREALIS_GL_AUDIT");
+    if (glAuditEnv != nullptr && atoi(glAuditEnv) != 0)
+        GLAudit::install();
+
+    glfwSwapInterval(Application::vsync && !Application::headless ? 1 : 0);
 
     Logger::info("GL Vendor: %s", glGetString(GL_VENDOR));
     Logger::info("GL Renderer: %s", glGetString(GL_RENDERER));
@@ -211,7 +256,20 @@ bool Application::init(std::string title, Style style, Theme theme)
     }
 
     // Initialize the scene
-    Application::vg = nvgCreateGL3(NVG_STENCIL_STROKES | NVG_ANTIALIAS);
+    // Vertices and uniforms go through ring buffers, unless BOREALIS_GL_STREAM_BUFFERS
+    // is set to compare with reallocating the buffers every frame
+    int nvgFlags = NVG_STENCIL_STROKES | NVG_ANTIALIAS;
+
+    char* streamBuffersEnv = getenv("BOREALIS_GL_STREAM_BUFFERS");
+    if (streamBuffersEnv == nullptr || atoi(streamBuffersEnv) == 0)
+        nvgFlags |= NVG_RING_BUFFERS;
+
+    // Consecutive fills and text are batched, unless BOREALIS_GL_BATCHING=0
+    char* batchingEnv = getenv("BOREALIS_GL_BATCHING");
+    if (batchingEnv == nullptr || atoi(batchingEnv) != 0)
+        nvgFlags |= NVG_BATCH_DRAWS;
+
+    Application::vg = nvgCreateGL3(nvgFlags);
     if (!vg)
     {
         Logger::error("Unable to init nanovg");
@@ -306,13 +364,6 @@ bool Application::init(std::string title, Style style, Theme theme)
         Application::currentThemeVariant = ThemeVariant_LIGHT;
 #endif
 
-    // Init window size
-    GLint viewport[4];
-    glGetIntegerv(GL_VIEWPORT, viewport);
-
-    Application::windowWidth  = viewport[2];
-    Application::windowHeight = viewport[3];
-
     // Init animations engine
     menu_animation_init();
 
@@ -324,10 +375,24 @@ bool Application::init(std::string title, Style style, Theme theme)
 
 bool Application::mainLoop()
 {
-    // Frame start
-    retro_time_t frameStart = 0;
-    if (Application::frameTime > 0.0f)
-        frameStart = cpu_features_get_time_usec();
+    // Wait for the next frame, sampling inputs in the meantime
+    // The frame limiter is bypassed with the virtual clock and for headless replays
+    bool headlessReplay = Application::headless && Application::inputReplayer.isReplaying();
+    if (Application::frameTime > 0.0f && !Clock::isVirtual() && !headlessReplay)
+        Application::waitForNextFrame();
+
+    retro_time_t frameBegin = cpu_features_get_time_usec();
+    uint64_t layouts        = Application::frameStats.layouts;
+
+    // Move on to the next recorded frame, quit once they have all been replayed
+    if (Application::inputReplayer.isReplaying() && !Application::inputReplayer.nextFrame())
+    {
+        Application::finishReplay();
+        Application::quit();
+    }
+
+    // Advance the virtual clock, if any
+    Clock::frame();
 
     // glfw events
     bool is_active;
@@ -355,91 +420,198 @@ bool Application::mainLoop()
     }
 #endif
 
-    // Gamepad
-    if (!glfwGetGamepadState(GLFW_JOYSTICK_1, &Application::gamepad))
+    // Inputs, sampled one last time as late as possible
+    if (Application::inputReplayer.isReplaying())
+        Application::inputReplayer.pushEvents(Application::inputManager);
+    else
+        Application::inputManager->sample();
+
+    Application::processInputs();
+    Application::inputRecorder.recordFrame(Clock::getTimeUsec(), &Application::gamepad);
+
+    // Handle window size changes, as reported by the framebuffer size callback
+    // Querying the viewport instead would stall the pipeline every frame
+    if (Application::windowSizeChanged)
     {
-        // Keyboard -> DPAD Mapping
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_DPAD_LEFT]    = glfwGetKey(window, GLFW_KEY_LEFT);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_DPAD_RIGHT]   = glfwGetKey(window, GLFW_KEY_RIGHT);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_DPAD_UP]      = glfwGetKey(window, GLFW_KEY_UP);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_DPAD_DOWN]    = glfwGetKey(window, GLFW_KEY_DOWN);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_START]        = glfwGetKey(window, GLFW_KEY_ESCAPE);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_BACK]         = glfwGetKey(window, GLFW_KEY_F1);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_A]            = glfwGetKey(window, GLFW_KEY_ENTER);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_B]            = glfwGetKey(window, GLFW_KEY_BACKSPACE);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_LEFT_BUMPER]  = glfwGetKey(window, GLFW_KEY_L);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER] = glfwGetKey(window, GLFW_KEY_R);
+        Application::windowSizeChanged = false;
+        Application::onWindowSizeChanged();
     }
 
-    // Trigger gamepad events
-    // TODO: Translate axis events to dpad events here
+    // Animations
+    menu_animation_update();
 
-    bool anyButtonPressed               = false;
-    bool repeating                      = false;
-    static retro_time_t buttonPressTime = 0;
-    static int repeatingButtonTimer     = 0;
+    // Tasks
+    Application::taskManager->frame();
 
-    for (int i = GLFW_GAMEPAD_BUTTON_A; i <= GLFW_GAMEPAD_BUTTON_LAST; i++)
-    {
-        if (Application::gamepad.buttons[i] == GLFW_PRESS)
-        {
-            anyButtonPressed = true;
-            repeating        = (repeatingButtonTimer > BUTTON_REPEAT_DELAY && repeatingButtonTimer % BUTTON_REPEAT_CADENCY == 0);
+    // Functions posted by other threads
+    Application::mainThreadQueue.dispatch(Application::mainThreadBudget);
 
-            if (Application::oldGamepad.buttons[i] != GLFW_PRESS || repeating)
-                Application::onGamepadButtonPressed(i, repeating);
-        }
+    // Render
+    Application::frame();
+    {
+        BRLS_PROFILE_SCOPE("glfwSwapBuffers");
+        glfwSwapBuffers(window);
 
-        if (Application::gamepad.buttons[i] != Application::oldGamepad.buttons[i])
-            buttonPressTime = repeatingButtonTimer = 0;
+#ifdef BRLS_FINISH_AT_SWAP
+        // Wait for the frame to be actually presented, for latency measurements
+        glFinish();
+#endif
     }
 
-    if (anyButtonPressed && cpu_features_get_time_usec() - buttonPressTime > 1000)
+    GLAudit::frame();
+
+    Application::recordFrameTimings(frameBegin);
+
+    int drawCalls = 0;
+    nvgFrameStats(Application::vg, &drawCalls, nullptr);
+
+    Application::frameStats.frames++;
+    Application::frameStats.drawCalls += drawCalls;
+    Application::frameStats.glDrawCalls += nvglDrawCallsGL3(Application::vg);
+
+    if (Application::inputReplayer.isReplaying())
+        Application::inputReplayer.recordFrameStats(cpu_features_get_time_usec() - frameBegin, Application::frameStats.layouts - layouts, drawCalls);
+
+    return true;
+}
+
+void Application::recordFrameTimings(retro_time_t frameBegin)
+{
+    retro_time_t now      = cpu_features_get_time_usec();
+    retro_time_t interval = Application::lastFrameBegin ? frameBegin - Application::lastFrameBegin : 0;
+
+    FlightRecorder::recordFrame(frameBegin, interval, now - frameBegin);
+
+    // Flag frames late by more than half a frame
+    retro_time_t budget = Application::frameTime > 0.0f ? (retro_time_t)(Application::frameTime * 1000) : 1000000 / DEFAULT_FPS;
+    if (interval > budget + budget / 2)
     {
-        buttonPressTime = cpu_features_get_time_usec();
-        repeatingButtonTimer++; // Increased once every ~1ms
+        char text[32];
+        snprintf(text, sizeof(text), "budget %ld us", (long)budget);
+        FlightRecorder::record(FlightEventType::SLOW_FRAME, (uint32_t)interval, nullptr, text);
     }
 
-    Application::oldGamepad = Application::gamepad;
+    Application::lastFrameBegin = frameBegin;
+}
+
+void Application::waitForNextFrame()
+{
+    retro_time_t frameTime = (retro_time_t)(Application::frameTime * 1000);
+    retro_time_t deadline  = Application::frameStart + frameTime;
+    retro_time_t now       = cpu_features_get_time_usec();
 
-    // Handle window size changes
-    GLint viewport[4];
-    glGetIntegerv(GL_VIEWPORT, viewport);
+    // While idle, skip frames until the next timer is due
+    bool idle = Application::idleSleep && Application::isIdle();
+    if (idle)
+    {
+        retro_time_t idleDeadline = Application::frameStart + IDLE_MAX_SLEEP;
+        retro_time_t nextTimer    = Application::taskManager->getNextDeadline();
 
-    unsigned newWidth  = viewport[2];
-    unsigned newHeight = viewport[3];
+        if (nextTimer >= 0)
+            idleDeadline = std::min(idleDeadline, now + (nextTimer - Clock::getTimeMs()) * 1000);
 
-    if (Application::windowWidth != newWidth || Application::windowHeight != newHeight)
+        deadline = std::max(deadline, idleDeadline);
+    }
+
+    // Gamepads are not event driven: instead of sleeping in one go, keep sampling
+    // them so that presses are timestamped and ready when the frame starts
+    retro_time_t period = Application::inputSamplingPeriod;
+
+    if (idle)
+        period = std::max(period, (retro_time_t)IDLE_SAMPLING_PERIOD);
+
+    while (now < deadline)
     {
-        Application::windowWidth  = newWidth;
-        Application::windowHeight = newHeight;
-        Application::onWindowSizeChanged();
+        glfwPollEvents();
+
+        if (!Application::inputReplayer.isReplaying())
+            Application::inputManager->sample();
+
+        // Wake up as soon as an input comes in
+        if (idle && Application::inputManager->hasPendingEvents())
+            break;
+
+        retro_time_t toSleep = deadline - now;
+        if (period > 0)
+            toSleep = std::min(toSleep, period);
+
+        // Window and keyboard events end the wait early
+        glfwWaitEventsTimeout(toSleep / 1000000.0);
+
+        now = cpu_features_get_time_usec();
     }
 
-    // Animations
-    menu_animation_update();
+    Application::frameStart = now;
+}
 
-    // Tasks
-    Application::taskManager->frame();
+bool Application::isIdle()
+{
+    return !menu_animation_is_active() && Application::repeatingButton == -1;
+}
 
-    // Render
-    Application::frame();
-    glfwSwapBuffers(window);
+void Application::setIdleSleep(bool enabled)
+{
+    Application::idleSleep = enabled;
+}
 
-    // Sleep if necessary
-    if (Application::frameTime > 0.0f)
+void Application::setInputSamplingPeriod(unsigned usec)
+{
+    Application::inputSamplingPeriod = usec;
+}
+
+void Application::processInputs()
+{
+    Application::inputEvents.clear();
+    Application::inputManager->drainEvents(&Application::inputEvents);
+
+    // Presses and releases, in the order they happened
+    for (InputEvent& event : Application::inputEvents)
     {
-        retro_time_t currentFrameTime = cpu_features_get_time_usec() - frameStart;
-        retro_time_t frameTime        = (retro_time_t)(Application::frameTime * 1000);
+        Application::gamepad.buttons[event.button] = event.pressed ? GLFW_PRESS : GLFW_RELEASE;
 
-        if (frameTime > currentFrameTime)
+        if (event.pressed)
         {
-            retro_time_t toSleep = frameTime - currentFrameTime;
-            std::this_thread::sleep_for(std::chrono::microseconds(toSleep));
+            Application::repeatingButton = event.button;
+            Application::repeatStartTime = event.timestamp + Application::keyRepeatCurve.delay * 1000;
+            Application::nextRepeatTime  = Application::repeatStartTime;
+
+            Application::onGamepadButtonPressed(event.button, false);
+        }
+        else if (event.button == Application::repeatingButton)
+        {
+            Application::repeatingButton = -1;
         }
     }
 
-    return true;
+    // Key repeat of the last pressed button, following the wall clock
+    // TODO: Translate axis events to dpad events here
+    if (Application::repeatingButton == -1)
+        return;
+
+    retro_time_t now = Clock::getTimeUsec();
+
+    for (unsigned i = 0; i < MAX_REPEATS_PER_FRAME && now >= Application::nextRepeatTime; i++)
+    {
+        Application::nextRepeatTime += Application::keyRepeatCurve.getInterval(Application::nextRepeatTime - Application::repeatStartTime);
+        Application::onGamepadButtonPressed(Application::repeatingButton, true);
+
+        if (Application::repeatingButton == -1)
+            return;
+    }
+
+    // Don't try to catch up after a long frame
+    if (now >= Application::nextRepeatTime)
+        Application::nextRepeatTime = now + Application::keyRepeatCurve.getInterval(now - Application::repeatStartTime);
+}
+
+void Application::setKeyRepeatCurve(KeyRepeatCurve curve)
+{
+    Application::keyRepeatCurve = curve;
+}
+
+KeyRepeatCurve* Application::getKeyRepeatCurve()
+{
+    return &Application::keyRepeatCurve;
 }
 
 void Application::quit()
@@ -457,7 +629,8 @@ void Application::navigate(FocusDirection direction)
         return;
 
     // Get next view to focus by traversing the views tree upwards
-    View* nextFocus = currentFocus->getParent()->getNextFocus(direction, currentFocus->getParentUserData());
+    Application::beginFocusLookups();
+    View* nextFocus = currentFocus->getParent()->getNextFocus(direction, currentFocus);
 
     while (!nextFocus) // stop when we find a view to focus
     {
@@ -465,9 +638,11 @@ void Application::navigate(FocusDirection direction)
             break;
 
         currentFocus = currentFocus->getParent();
-        nextFocus    = currentFocus->getParent()->getNextFocus(direction, currentFocus->getParentUserData());
+        nextFocus    = currentFocus->getParent()->getNextFocus(direction, currentFocus);
     }
 
+    Application::endFocusLookups();
+
     // No view to focus at the end of the traversal: wiggle and return
     if (!nextFocus)
     {
@@ -479,6 +654,125 @@ void Application::navigate(FocusDirection direction)
     Application::giveFocus(nextFocus);
 }
 
+void Application::navigatePage(FocusDirection direction)
+{
+    View* currentFocus = Application::currentFocus;
+
+    if (!currentFocus)
+        return;
+
+    // Find the first parent able to move by one page
+    View* nextFocus = nullptr;
+
+    Application::beginFocusLookups();
+
+    for (View* parent = currentFocus->getParent(); parent && !nextFocus; parent = parent->getParent())
+        nextFocus = parent->getNextPageFocus(direction, currentFocus);
+
+    Application::endFocusLookups();
+
+    if (!nextFocus || nextFocus == currentFocus)
+    {
+        currentFocus->shakeHighlight(direction);
+        return;
+    }
+
+    Application::giveFocus(nextFocus);
+}
+
+void Application::beginFocusLookups()
+{
+    Application::focusStats.lastLookups = 0;
+}
+
+void Application::endFocusLookups()
+{
+    FocusStats* stats = &Application::focusStats;
+
+    stats->maxLookups = std::max(stats->maxLookups, stats->lastLookups);
+    stats->totalLookups += stats->lastLookups;
+    stats->navigations++;
+}
+
+void Application::countFocusLookup()
+{
+    Application::focusStats.lastLookups++;
+}
+
+FocusStats* Application::getFocusStats()
+{
+    return &Application::focusStats;
+}
+
+void Application::countLayout()
+{
+    Application::frameStats.layouts++;
+}
+
+FrameStats* Application::getFrameStats()
+{
+    return &Application::frameStats;
+}
+
+void Application::setHeadless(bool headless)
+{
+    Application::headless = headless;
+}
+
+bool Application::recordInputs(std::string path)
+{
+    return Application::inputRecorder.start(path);
+}
+
+void Application::stopRecordingInputs()
+{
+    Application::inputRecorder.stop();
+}
+
+bool Application::replayInputs(std::string path, std::string reportPath)
+{
+    if (!Application::inputReplayer.load(path))
+        return false;
+
+    // The recorded timestamps take over the clock
+    if (Clock::isVirtual())
+    {
+        Logger::info("Replaying inputs, switching back from the virtual clock to the recorded timestamps");
+        Clock::setReal();
+    }
+
+    Clock::setTimeSource([]() { return Application::inputReplayer.getTime(); });
+
+    Application::replayReportPath = reportPath.empty() ? path + ".report.json" : reportPath;
+    return true;
+}
+
+bool Application::isReplayingInputs()
+{
+    return Application::inputReplayer.isReplaying();
+}
+
+void Application::injectButton(int button, bool pressed, retro_time_t timestamp)
+{
+    if (button < 0 || button > GLFW_GAMEPAD_BUTTON_LAST)
+        return;
+
+    if (timestamp < 0)
+        timestamp = Clock::getTimeUsec();
+
+    Application::inputManager->pushEvent({ button, pressed, timestamp });
+}
+
+void Application::finishReplay()
+{
+    // Only report once, either at the end of the replay or when exiting
+    if (Application::replayReportPath.empty())
+        return;
+
+    Application::inputReplayer.writeReport(Application::replayReportPath);
+    Application::replayReportPath.clear();
+}
+
 void Application::onGamepadButtonPressed(char button, bool repeating)
 {
     if (Application::blockInputsTokens != 0)
@@ -510,6 +804,12 @@ void Application::onGamepadButtonPressed(char button, bool repeating)
         case GLFW_GAMEPAD_BUTTON_DPAD_RIGHT:
             Application::navigate(FocusDirection::RIGHT);
             break;
+        case GLFW_GAMEPAD_BUTTON_LEFT_BUMPER:
+            Application::navigatePage(FocusDirection::UP);
+            break;
+        case GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER:
+            Application::navigatePage(FocusDirection::DOWN);
+            break;
         default:
             break;
     }
@@ -520,30 +820,82 @@ View* Application::getCurrentFocus()
     return Application::currentFocus;
 }
 
+ActionTable* Application::getActionTable()
+{
+    if (Application::actionTableDirty)
+    {
+        Application::actionTable.build(Application::currentFocus);
+        Application::actionTableDirty = false;
+        Application::actionTableVersion++;
+    }
+
+    return &Application::actionTable;
+}
+
+void Application::invalidateActionTable(View* view)
+{
+    // Called for every destroyed or reparented view, keep it cheap for the others
+    if (!Application::actionTable.isOnFocusPath(view))
+        return;
+
+    // Forget the view now, it may be about to be freed
+    Application::actionTable.remove(view);
+    Application::actionTableDirty = true;
+}
+
 bool Application::handleAction(char button)
 {
-    View* hintParent = Application::currentFocus;
-    std::set<Key> consumedKeys;
+    if (button < 0 || button >= BRLS_KEYS_COUNT)
+        return false;
+
+    Key key            = static_cast<Key>(button);
+    ActionTable* table = Application::getActionTable();
+
+    if (!table->hasAvailableAction(key))
+        return false;
 
-    while (hintParent != nullptr)
+    size_t count;
+    const ActionRef* actions = table->getActions(key, &count);
+    unsigned version         = Application::actionTableVersion;
+
+    // Views left to walk once the table has been rebuilt: listeners may destroy
+    // views, so they are only compared with the views of the new table, never dereferenced
+    bool rebuilt                 = false;
+    std::vector<View*> remaining = table->getFocusPath();
+
+    // Actions are ordered from the focused view up to the root,
+    // the first one to consume the key wins
+    for (size_t i = 0; i < count; i++)
     {
-        for (auto& action : hintParent->getActions())
-        {
-            if (action.key != static_cast<Key>(button))
-                continue;
+        View* view = actions[i].view;
 
-            if (consumedKeys.find(action.key) != consumedKeys.end())
-                continue;
+        if (rebuilt && std::find(remaining.begin(), remaining.end(), view) == remaining.end())
+            continue;
 
-            if (action.available)
-                if (action.actionListener())
-                    consumedKeys.insert(action.key);
-        }
+        const Action& action = actions[i].get();
 
-        hintParent = hintParent->getParent();
+        if (!action.available)
+            continue;
+
+        if (action.actionListener())
+            return true;
+
+        // The listener changed the focus path or its actions: the remaining references
+        // cannot be trusted anymore, walk up the remaining ancestors of the view in the new table
+        if (Application::actionTableDirty || Application::actionTableVersion != version)
+        {
+            auto walked = std::find(remaining.begin(), remaining.end(), view);
+            remaining.erase(remaining.begin(), walked == remaining.end() ? walked : walked + 1);
+
+            table   = Application::getActionTable();
+            actions = table->getActions(key, &count);
+            version = Application::actionTableVersion;
+            rebuilt = true;
+            i       = (size_t)-1;
+        }
     }
 
-    return !consumedKeys.empty();
+    return false;
 }
 
 void Application::frame()
@@ -566,7 +918,8 @@ void Application::frame()
         frameContext.theme->backgroundColor[2],
         1.0f);
 
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    // nanovg only uses the stencil buffer, there is no depth to clear
+    glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
     std::vector<View*> viewsToDraw;
 
@@ -596,7 +949,11 @@ void Application::frame()
 
     // End frame
     nvgResetTransform(Application::vg); // scale
-    nvgEndFrame(Application::vg);
+
+    {
+        BRLS_PROFILE_SCOPE("nvgEndFrame");
+        nvgEndFrame(Application::vg);
+    }
 }
 
 void Application::exit()
@@ -608,13 +965,30 @@ void Application::exit()
 
     glfwTerminate();
 
+    GLAudit::logSummary();
+
     menu_animation_free();
 
     if (Application::framerateCounter)
         delete Application::framerateCounter;
 
+    // Join the workers before the managers their completions may use go away
+    delete Application::threadPool;
+    Application::threadPool = nullptr;
+
     delete Application::taskManager;
     delete Application::notificationManager;
+    delete Application::inputManager;
+
+    Application::inputRecorder.stop();
+
+    if (Application::inputReplayer.isReplaying())
+        Application::finishReplay();
+
+    // Every thread is done by now
+    Profiler::stop();
+
+    Logger::flush();
 }
 
 void Application::setDisplayFramerate(bool enabled)
@@ -663,9 +1037,42 @@ void Application::resizeNotificationManager()
 
 void Application::notify(std::string text)
 {
+    BRLS_ASSERT_MAIN_THREAD();
+
     Application::notificationManager->notify(text);
 }
 
+void Application::runOnMainThread(std::function<void(void)> func)
+{
+    Application::mainThreadQueue.push(func);
+}
+
+void Application::runOnMainThread(const void* key, std::function<void(void)> func)
+{
+    Application::mainThreadQueue.push(func, key);
+}
+
+void Application::setMainThreadBudget(retro_time_t budget)
+{
+    Application::mainThreadBudget = budget;
+}
+
+bool Application::isMainThread()
+{
+    // Anything goes before init()
+    return Application::mainThreadId == std::thread::id() || Application::mainThreadId == std::this_thread::get_id();
+}
+
+void Application::assertMainThread(const char* function)
+{
+    if (Application::isMainThread())
+        return;
+
+    Logger::error("%s() called outside of the main thread, use Application::runOnMainThread()", function);
+    Logger::flush();
+    abort();
+}
+
 NotificationManager* Application::getNotificationManager()
 {
     return Application::notificationManager;
@@ -673,6 +1080,8 @@ NotificationManager* Application::getNotificationManager()
 
 void Application::giveFocus(View* view)
 {
+    BRLS_ASSERT_MAIN_THREAD();
+
     View* oldFocus = Application::currentFocus;
     View* newFocus = view ? view->getDefaultFocus() : nullptr;
 
@@ -681,19 +1090,24 @@ void Application::giveFocus(View* view)
         if (oldFocus)
             oldFocus->onFocusLost();
 
-        Application::currentFocus = newFocus;
+        Application::currentFocus     = newFocus;
+        Application::actionTableDirty = true;
+
+        FlightRecorder::record(FlightEventType::FOCUS, 0, newFocus, newFocus ? typeid(*newFocus).name() : nullptr);
         Application::globalFocusChangeEvent.fire(newFocus);
 
         if (newFocus)
         {
             newFocus->onFocusGained();
-            Logger::debug("Giving focus to %s", newFocus->describe().c_str());
+            BRLS_LOG_DEBUG(LogSubsystem::FOCUS, "Giving focus to %s", newFocus->describe().c_str());
         }
     }
 }
 
 void Application::popView(ViewAnimation animation, std::function<void(void)> cb)
 {
+    BRLS_ASSERT_MAIN_THREAD();
+
     if (Application::viewStack.size() <= 1) // never pop the root view
         return;
 
@@ -709,9 +1123,18 @@ void Application::popView(ViewAnimation animation, std::function<void(void)> cb)
     // Hide animation (and show previous view, if any)
     last->hide([last, animation, wait, cb]() {
         last->setForceTranslucent(false);
+
+        FlightRecorder::record(FlightEventType::VIEW_POP, Application::viewStack.size(), last, typeid(*last).name());
         Application::viewStack.pop_back();
+
+        // Free the view, and its arena if that was the last reference:
+        // the one taken at push time keeps it alive until then
+        ViewArena* arena = ViewArena::getArena(last);
         delete last;
 
+        if (arena)
+            arena->release();
+
         // Animate the old view once the new one
         // has ended its animation
         if (Application::viewStack.size() > 0 && wait)
@@ -746,7 +1169,7 @@ void Application::popView(ViewAnimation animation, std::function<void(void)> cb)
     {
         View* newFocus = Application::focusStack[Application::focusStack.size() - 1];
 
-        Logger::debug("Giving focus to %s, and removing it from the focus stack", newFocus->describe().c_str());
+        BRLS_LOG_DEBUG(LogSubsystem::FOCUS, "Giving focus to %s, and removing it from the focus stack", newFocus->describe().c_str());
 
         Application::giveFocus(newFocus);
         Application::focusStack.pop_back();
@@ -755,6 +1178,8 @@ void Application::popView(ViewAnimation animation, std::function<void(void)> cb)
 
 void Application::pushView(View* view, ViewAnimation animation)
 {
+    BRLS_ASSERT_MAIN_THREAD();
+
     Application::blockInputs();
 
     // Call hide() on the previous view in the stack if no
@@ -766,6 +1191,10 @@ void Application::pushView(View* view, ViewAnimation animation)
     bool fadeOut = last && !last->isTranslucent() && !view->isTranslucent(); // play the fade out animation?
     bool wait    = animation == ViewAnimation::FADE; // wait for the old view animation to be done before showing the new one?
 
+    // Keep the arena of the view alive until it's popped
+    if (ViewArena* arena = ViewArena::getArena(view))
+        arena->retain();
+
     view->registerAction("Exit", Key::PLUS, [] { Application::quit(); return true; });
     view->registerAction(
         "FPS", Key::MINUS, [] { Application::toggleFramerateDisplay(); return true; }, true);
@@ -806,7 +1235,7 @@ void Application::pushView(View* view, ViewAnimation animation)
     // Focus
     if (Application::viewStack.size() > 0)
     {
-        Logger::debug("Pushing %s to the focus stack", Application::currentFocus->describe().c_str());
+        BRLS_LOG_DEBUG(LogSubsystem::FOCUS, "Pushing %s to the focus stack", Application::currentFocus->describe().c_str());
         Application::focusStack.push_back(Application::currentFocus);
     }
 
@@ -817,6 +1246,18 @@ void Application::pushView(View* view, ViewAnimation animation)
 
     // And push it
     Application::viewStack.push_back(view);
+
+    FlightRecorder::record(FlightEventType::VIEW_PUSH, Application::viewStack.size(), view, typeid(*view).name());
+}
+
+void Application::setWindowSize(unsigned width, unsigned height)
+{
+    if (Application::windowWidth == width && Application::windowHeight == height)
+        return;
+
+    Application::windowWidth       = width;
+    Application::windowHeight      = height;
+    Application::windowSizeChanged = true;
 }
 
 void Application::onWindowSizeChanged()
@@ -840,7 +1281,13 @@ void Application::clear()
     for (View* view : Application::viewStack)
     {
         view->willDisappear(true);
+
+        // Release the arena reference taken at push time
+        ViewArena* arena = ViewArena::getArena(view);
         delete view;
+
+        if (arena)
+            arena->release();
     }
 
     Application::viewStack.clear();
@@ -888,6 +1335,8 @@ int Application::findFont(const char* fontName)
 
 void Application::crash(std::string text)
 {
+    FlightRecorder::record(FlightEventType::CRASH, 0, nullptr, text.c_str());
+
     CrashFrame* crashFrame = new CrashFrame(text);
     Application::pushView(crashFrame);
 }
@@ -913,6 +1362,16 @@ TaskManager* Application::getTaskManager()
     return Application::taskManager;
 }
 
+ThreadPool* Application::getThreadPool()
+{
+    return Application::threadPool;
+}
+
+InputManager* Application::getInputManager()
+{
+    return Application::inputManager;
+}
+
 void Application::setCommonFooter(std::string footer)
 {
     Application::commonFooter = footer;
@@ -931,13 +1390,13 @@ FramerateCounter::FramerateCounter()
     this->setHorizontalAlign(NVG_ALIGN_RIGHT);
     this->setBackground(Background::BACKDROP);
 
-    this->lastSecond = cpu_features_get_time_usec() / 1000;
+    this->lastSecond = Clock::getTimeMs();
 }
 
 void FramerateCounter::frame(FrameContext* ctx)
 {
     // Update counter
-    retro_time_t current = cpu_features_get_time_usec() / 1000;
+    retro_time_t current = Clock::getTimeMs();
 
     if (current - this->lastSecond >= 1000)
     {
@@ -968,6 +1427,15 @@ void Application::setMaximumFPS(unsigned fps)
     Logger::info("Maximum FPS set to %d - using a frame time of %.2f ms", fps, Application::frameTime);
 }
 
+void Application::setVSync(bool enabled)
+{
+    Application::vsync = enabled;
+
+    // Otherwise applied at init
+    if (Application::window)
+        glfwSwapInterval(Application::vsync && !Application::headless ? 1 : 0);
+}
+
 std::string Application::getTitle()
 {
     return Application::title;
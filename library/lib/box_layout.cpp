@@ -21,6 +21,7 @@
 #include <math.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <borealis/animations.hpp>
 #include <borealis/application.hpp>
 #include <borealis/box_layout.hpp>
@@ -40,8 +41,8 @@ BoxLayout::BoxLayout(BoxLayoutOrientation orientation, size_t defaultFocus)
 void BoxLayout::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx)
 {
     // Draw children
-    for (BoxLayoutChild* child : this->children)
-        child->view->frame(ctx);
+    for (BoxLayoutChild& child : this->children)
+        child.view->frame(ctx);
 }
 
 void BoxLayout::setGravity(BoxLayoutGravity gravity)
@@ -86,16 +87,16 @@ View* BoxLayout::getDefaultFocus()
     // Focus default focus first
     if (this->defaultFocusedIndex < this->children.size())
     {
-        View* newFocus = this->children[this->defaultFocusedIndex]->view->getDefaultFocus();
+        View* newFocus = this->children[this->defaultFocusedIndex].view->getDefaultFocus();
 
         if (newFocus)
             return newFocus;
     }
 
     // Fallback to finding the first focusable view
-    for (size_t i = 0; i < this->children.size(); i++)
+    for (size_t index : this->focusableChildren)
     {
-        View* newFocus = this->children[i]->view->getDefaultFocus();
+        View* newFocus = this->children[index].view->getDefaultFocus();
 
         if (newFocus)
             return newFocus;
@@ -104,7 +105,38 @@ View* BoxLayout::getDefaultFocus()
     return nullptr;
 }
 
-View* BoxLayout::getNextFocus(FocusDirection direction, void* parentUserData)
+View* BoxLayout::getChildFocus(size_t index)
+{
+    Application::countFocusLookup();
+    return this->children[index].view->getDefaultFocus();
+}
+
+void BoxLayout::updateFocusableChild(size_t index, bool focusable)
+{
+    bool wasEmpty = this->focusableChildren.empty();
+
+    auto it      = std::lower_bound(this->focusableChildren.begin(), this->focusableChildren.end(), index);
+    bool indexed = it != this->focusableChildren.end() && *it == index;
+
+    if (focusable && !indexed)
+        this->focusableChildren.insert(it, index);
+    else if (!focusable && indexed)
+        this->focusableChildren.erase(it);
+
+    // Our own focusability only changes when the index becomes (non) empty
+    if (wasEmpty != this->focusableChildren.empty())
+        this->notifyFocusabilityChanged();
+}
+
+void BoxLayout::onChildFocusabilityChanged(View* child)
+{
+    size_t index = child->getParentIndex();
+
+    if (index < this->children.size() && this->children[index].view == child)
+        this->updateFocusableChild(index, child->getDefaultFocus() != nullptr);
+}
+
+View* BoxLayout::getNextFocus(FocusDirection direction, View* currentView)
 {
     // Return nullptr immediately if focus direction mismatches the layout direction
     if ((this->orientation == BoxLayoutOrientation::HORIZONTAL && direction != FocusDirection::LEFT && direction != FocusDirection::RIGHT) || (this->orientation == BoxLayoutOrientation::VERTICAL && direction != FocusDirection::UP && direction != FocusDirection::DOWN))
@@ -120,32 +152,74 @@ View* BoxLayout::getNextFocus(FocusDirection direction, void* parentUserData)
         offset = -1;
     }
 
-    size_t currentFocusIndex = *((size_t*)parentUserData) + offset;
-    View* currentFocus       = nullptr;
+    size_t currentFocusIndex = currentView->getParentIndex();
 
-    while (!currentFocus && currentFocusIndex >= 0 && currentFocusIndex < this->children.size())
+    // Only visit the children known to give focus - a child can still
+    // refuse it (during a collapse animation), so keep looking if it does
+    if (offset == 1)
     {
-        currentFocus = this->children[currentFocusIndex]->view->getDefaultFocus();
-        currentFocusIndex += offset;
+        auto it = std::upper_bound(this->focusableChildren.begin(), this->focusableChildren.end(), currentFocusIndex);
+
+        for (; it != this->focusableChildren.end(); it++)
+        {
+            if (View* newFocus = this->getChildFocus(*it))
+                return newFocus;
+        }
     }
+    else
+    {
+        auto it = std::lower_bound(this->focusableChildren.begin(), this->focusableChildren.end(), currentFocusIndex);
 
-    return currentFocus;
+        while (it != this->focusableChildren.begin())
+        {
+            if (View* newFocus = this->getChildFocus(*--it))
+                return newFocus;
+        }
+    }
+
+    return nullptr;
 }
 
 void BoxLayout::removeView(int index, bool free)
 {
-    BoxLayoutChild* toRemove = this->children[index];
-    toRemove->view->willDisappear(true);
+    View* toRemove = this->children[index].view;
+    toRemove->willDisappear(true);
     if (free)
-        delete toRemove->view;
-    delete toRemove;
+        delete toRemove;
     this->children.erase(this->children.begin() + index);
+
+    // Renumber the following children
+    for (size_t i = index; i < this->children.size(); i++)
+        this->children[i].view->setParentIndex(i);
+
+    // Shift the focus index
+    this->updateFocusableChild(index, false);
+
+    for (size_t& focusableIndex : this->focusableChildren)
+    {
+        if (focusableIndex > (size_t)index)
+            focusableIndex--;
+    }
 }
 
 void BoxLayout::clear(bool free)
 {
-    while (!this->children.empty())
-        this->removeView(0, free);
+    // Tear everything down at once instead of renumbering
+    // the remaining children after every removal
+    for (BoxLayoutChild& child : this->children)
+    {
+        child.view->willDisappear(true);
+        if (free)
+            delete child.view;
+    }
+
+    this->children.clear();
+
+    if (!this->focusableChildren.empty())
+    {
+        this->focusableChildren.clear();
+        this->notifyFocusabilityChanged();
+    }
 }
 
 void BoxLayout::layout(NVGcontext* vg, Style* style, FontStash* stash)
@@ -158,32 +232,32 @@ void BoxLayout::layout(NVGcontext* vg, Style* style, FontStash* stash)
 
         for (size_t i = 0; i < this->children.size(); i++)
         {
-            BoxLayoutChild* child = this->children[i];
-            unsigned childHeight  = child->view->getHeight();
+            BoxLayoutChild& child = this->children[i];
+            unsigned childHeight  = child.view->getHeight();
 
-            if (child->fill)
-                child->view->setBoundaries(this->x + this->marginLeft,
+            if (child.fill)
+                child.view->setBoundaries(this->x + this->marginLeft,
                     yAdvance,
                     this->width - this->marginLeft - this->marginRight,
                     this->y + this->height - yAdvance - this->marginBottom);
             else
-                child->view->setBoundaries(this->x + this->marginLeft,
+                child.view->setBoundaries(this->x + this->marginLeft,
                     yAdvance,
                     this->width - this->marginLeft - this->marginRight,
-                    child->view->getHeight(false));
+                    child.view->getHeight(false));
 
-            child->view->invalidate(true); // call layout directly in case height is updated
-            childHeight = child->view->getHeight();
+            child.view->invalidate(true); // call layout directly in case height is updated
+            childHeight = child.view->getHeight();
 
             int spacing = (int)this->spacing;
-            View* next  = (this->children.size() > 1 && i <= this->children.size() - 2) ? this->children[i + 1]->view : nullptr;
+            View* next  = (this->children.size() > 1 && i <= this->children.size() - 2) ? this->children[i + 1].view : nullptr;
 
-            this->customSpacing(child->view, next, &spacing);
+            this->customSpacing(child.view, next, &spacing);
 
-            if (child->view->isCollapsed())
+            if (child.view->isCollapsed())
                 spacing = 0;
 
-            if (!child->view->isHidden())
+            if (!child.view->isHidden())
                 entriesHeight += spacing + childHeight;
 
             yAdvance += spacing + childHeight;
@@ -202,30 +276,30 @@ void BoxLayout::layout(NVGcontext* vg, Style* style, FontStash* stash)
         int xAdvance = this->x + this->marginLeft;
         for (size_t i = 0; i < this->children.size(); i++)
         {
-            BoxLayoutChild* child = this->children[i];
-            unsigned childWidth   = child->view->getWidth();
+            BoxLayoutChild& child = this->children[i];
+            unsigned childWidth   = child.view->getWidth();
 
-            if (child->fill)
-                child->view->setBoundaries(xAdvance,
+            if (child.fill)
+                child.view->setBoundaries(xAdvance,
                     this->y + this->marginTop,
                     this->x + this->width - xAdvance - this->marginRight,
                     this->height - this->marginTop - this->marginBottom);
             else
-                child->view->setBoundaries(xAdvance,
+                child.view->setBoundaries(xAdvance,
                     this->y + this->marginTop,
                     childWidth,
                     this->height - this->marginTop - this->marginBottom);
 
-            child->view->invalidate(true); // call layout directly in case width is updated
-            childWidth = child->view->getWidth();
+            child.view->invalidate(true); // call layout directly in case width is updated
+            childWidth = child.view->getWidth();
 
             int spacing = (int)this->spacing;
 
-            View* next = (this->children.size() > 1 && i <= this->children.size() - 2) ? this->children[i + 1]->view : nullptr;
+            View* next = (this->children.size() > 1 && i <= this->children.size() - 2) ? this->children[i + 1].view : nullptr;
 
-            this->customSpacing(child->view, next, &spacing);
+            this->customSpacing(child.view, next, &spacing);
 
-            if (child->view->isCollapsed())
+            if (child.view->isCollapsed())
                 spacing = 0;
 
             xAdvance += spacing + childWidth;
@@ -241,7 +315,7 @@ void BoxLayout::layout(NVGcontext* vg, Style* style, FontStash* stash)
                 {
                     // Take the remaining empty space between the last view's
                     // right boundary and ours and push all views by this amount
-                    View* lastView = this->children[this->children.size() - 1]->view;
+                    View* lastView = this->children[this->children.size() - 1].view;
 
                     unsigned lastViewRight = lastView->getX() + lastView->getWidth();
                     unsigned ourRight      = this->getX() + this->getWidth();
@@ -250,9 +324,9 @@ void BoxLayout::layout(NVGcontext* vg, Style* style, FontStash* stash)
                     {
                         unsigned difference = ourRight - lastViewRight;
 
-                        for (BoxLayoutChild* child : this->children)
+                        for (BoxLayoutChild& child : this->children)
                         {
-                            View* view = child->view;
+                            View* view = child.view;
                             view->setBoundaries(
                                 view->getX() + difference,
                                 view->getY(),
@@ -279,28 +353,134 @@ void BoxLayout::setResize(bool resize)
     this->invalidate();
 }
 
-void BoxLayout::addView(View* view, bool fill, bool resetState)
+void BoxLayout::appendChild(View* view, bool fill)
 {
-    BoxLayoutChild* child = new BoxLayoutChild();
-    child->view           = view;
-    child->fill           = fill;
-
-    this->children.push_back(child);
+    this->children.push_back({ view, fill });
 
     size_t position = this->children.size() - 1;
 
-    size_t* userdata = (size_t*)malloc(sizeof(size_t));
-    *userdata        = position;
+    view->setParent(this, position);
 
-    view->setParent(this, userdata);
+    this->updateFocusableChild(position, view->getDefaultFocus() != nullptr);
+}
+
+void BoxLayout::addView(View* view, bool fill, bool resetState)
+{
+    this->appendChild(view, fill);
+
+    if (this->builderMode)
+        return;
 
     view->willAppear(resetState);
     this->invalidate();
 }
 
+void BoxLayout::addViews(const std::vector<View*>& views, bool fill, bool resetState)
+{
+    this->reserve(this->children.size() + views.size());
+
+    for (View* view : views)
+        this->appendChild(view, fill);
+
+    if (this->builderMode)
+        return;
+
+    for (View* view : views)
+        view->willAppear(resetState);
+
+    this->invalidate();
+}
+
+void BoxLayout::reserve(size_t count)
+{
+    this->children.reserve(count);
+}
+
+void BoxLayout::setBuilderMode(bool builderMode)
+{
+    if (this->builderMode == builderMode)
+        return;
+
+    this->builderMode = builderMode;
+
+    if (builderMode)
+    {
+        this->builderModeStart = this->children.size();
+        return;
+    }
+
+    // Catch up with the views added in the meantime
+    for (size_t i = this->builderModeStart; i < this->children.size(); i++)
+        this->children[i].view->willAppear(true);
+
+    this->invalidate();
+}
+
 View* BoxLayout::getChild(size_t index)
 {
-    return this->children[index]->view;
+    return this->children[index].view;
+}
+
+View* BoxLayout::getFocusNearIndex(size_t index, FocusDirection direction)
+{
+    auto begin = this->focusableChildren.begin();
+    auto end   = this->focusableChildren.end();
+
+    // First child at or after the index, first child after the index
+    auto lower = std::lower_bound(begin, end, index);
+    auto upper = (lower != end && *lower == index) ? lower + 1 : lower;
+
+    // Look in the requested direction first (including the index), then the other way
+    if (direction == FocusDirection::DOWN || direction == FocusDirection::RIGHT)
+    {
+        for (auto it = lower; it != end; it++)
+            if (View* focus = this->getChildFocus(*it))
+                return focus;
+
+        for (auto it = lower; it != begin;)
+            if (View* focus = this->getChildFocus(*--it))
+                return focus;
+    }
+    else
+    {
+        for (auto it = upper; it != begin;)
+            if (View* focus = this->getChildFocus(*--it))
+                return focus;
+
+        for (auto it = upper; it != end; it++)
+            if (View* focus = this->getChildFocus(*it))
+                return focus;
+    }
+
+    return nullptr;
+}
+
+bool BoxLayout::jumpToIndex(size_t index)
+{
+    View* focus = this->getFocusNearIndex(index, FocusDirection::DOWN);
+
+    if (!focus)
+        return false;
+
+    Application::giveFocus(focus);
+    return true;
+}
+
+View* BoxLayout::getFocusAtPosition(int position, FocusDirection direction)
+{
+    bool vertical = this->orientation == BoxLayoutOrientation::VERTICAL;
+
+    // Children are laid out in order: find the first one ending after the position
+    auto it = std::partition_point(this->children.begin(), this->children.end(), [vertical, position](BoxLayoutChild& child) {
+        View* view = child.view;
+
+        if (vertical)
+            return view->getY() + (int)view->getHeight() <= position;
+        else
+            return view->getX() + (int)view->getWidth() <= position;
+    });
+
+    return this->getFocusNearIndex(std::distance(this->children.begin(), it), direction);
 }
 
 bool BoxLayout::isEmpty()
@@ -320,7 +500,7 @@ void BoxLayout::onChildFocusGained(View* child)
     // Remember focus if needed
     if (this->rememberFocus)
     {
-        size_t index              = *((size_t*)child->getParentUserData());
+        size_t index              = child->getParentIndex();
         this->defaultFocusedIndex = index;
     }
 
@@ -336,11 +516,10 @@ void BoxLayout::onChildFocusLost(View* child)
 
 BoxLayout::~BoxLayout()
 {
-    for (BoxLayoutChild* child : this->children)
+    for (BoxLayoutChild& child : this->children)
     {
-        child->view->willDisappear(true);
-        delete child->view;
-        delete child;
+        child.view->willDisappear(true);
+        delete child.view;
     }
 
     this->children.clear();
@@ -348,14 +527,17 @@ BoxLayout::~BoxLayout()
 
 void BoxLayout::willAppear(bool resetState)
 {
-    for (BoxLayoutChild* child : this->children)
-        child->view->willAppear(resetState);
+    // Appearing ends the builder mode, all children are covered below
+    this->builderMode = false;
+
+    for (BoxLayoutChild& child : this->children)
+        child.view->willAppear(resetState);
 }
 
 void BoxLayout::willDisappear(bool resetState)
 {
-    for (BoxLayoutChild* child : this->children)
-        child->view->willDisappear(resetState);
+    for (BoxLayoutChild& child : this->children)
+        child.view->willDisappear(resetState);
 
     // Reset default focus to original one if needed
     if (this->rememberFocus)
@@ -364,8 +546,8 @@ void BoxLayout::willDisappear(bool resetState)
 
 void BoxLayout::onWindowSizeChanged()
 {
-    for (BoxLayoutChild* child : this->children)
-        child->view->onWindowSizeChanged();
+    for (BoxLayoutChild& child : this->children)
+        child.view->onWindowSizeChanged();
 }
 
 void BoxLayout::setRememberFocus(bool remember)
@@ -0,0 +1,77 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <borealis/clock.hpp>
+#include <borealis/logger.hpp>
+
+namespace brls
+{
+
+retro_time_t Clock::getTimeUsec()
+{
+    if (Clock::virtualClock.load(std::memory_order_acquire))
+        return Clock::virtualTime.load(std::memory_order_relaxed);
+
+    if (TimeSource source = Clock::timeSource.load(std::memory_order_acquire))
+        return source();
+
+    return cpu_features_get_time_usec();
+}
+
+retro_time_t Clock::getTimeMs()
+{
+    return Clock::getTimeUsec() / 1000;
+}
+
+void Clock::setTimeSource(TimeSource source)
+{
+    Clock::timeSource.store(source, std::memory_order_release);
+}
+
+void Clock::setVirtual(float frameStep)
+{
+    Clock::virtualTime.store(0, std::memory_order_relaxed);
+    Clock::frameStep = (retro_time_t)(frameStep * 1000.0f);
+    Clock::virtualClock.store(true, std::memory_order_release);
+
+    Logger::info("Using a virtual clock - advancing by %.2f ms every frame", frameStep);
+}
+
+void Clock::setReal()
+{
+    Clock::virtualClock.store(false, std::memory_order_release);
+}
+
+bool Clock::isVirtual()
+{
+    return Clock::virtualClock.load(std::memory_order_relaxed);
+}
+
+retro_time_t Clock::getFrameStep()
+{
+    return Clock::frameStep;
+}
+
+void Clock::frame()
+{
+    if (Clock::virtualClock.load(std::memory_order_relaxed))
+        Clock::virtualTime.fetch_add(Clock::frameStep, std::memory_order_relaxed);
+}
+
+} // namespace brls
@@ -28,6 +28,10 @@ namespace brls
 
 CrashFrame::CrashFrame(std::string text)
 {
+    // Keep a record of what led there
+    if (FlightRecorder::dump())
+        Logger::info("Flight recorder dumped to %s", FlightRecorder::getDumpPath());
+
     // Label
     this->label = new Label(LabelStyle::CRASH, text, true);
     this->label->setHorizontalAlign(NVG_ALIGN_CENTER);
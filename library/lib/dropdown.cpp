@@ -46,6 +46,10 @@ Dropdown::Dropdown(std::string title, std::vector<std::string> values, ValueSele
     this->list->setParent(this);
     this->list->setMargins(1, 0, 1, 0);
 
+    // The list appears with the dropdown
+    this->list->reserve(values.size());
+    this->list->setBuilderMode(true);
+
     for (size_t i = 0; i < values.size(); i++)
     {
         std::string value = values[i];
@@ -2194,6 +2194,14 @@ void nvgCircle(NVGcontext* ctx, float cx, float cy, float r)
 	nvgEllipse(ctx, cx,cy, r,r);
 }
 
+void nvgFrameStats(NVGcontext* ctx, int* drawCalls, int* triangles)
+{
+	if (drawCalls != NULL)
+		*drawCalls = ctx->drawCallCount;
+	if (triangles != NULL)
+		*triangles = ctx->fillTriCount + ctx->strokeTriCount + ctx->textTriCount;
+}
+
 void nvgDebugDumpPathCache(NVGcontext* ctx)
 {
 	const NVGpath* path;
@@ -0,0 +1,214 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <borealis/flight_recorder.hpp>
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+// Dump layout, all little endian:
+//   char magic[8] "BRLSFLT1"
+//   uint32 eventSize, eventsCount, frameSize, framesCount
+//   uint64 nextFrame (index of the next frame to be written)
+//   FlightEvent events[eventsCount]
+//   FlightFrame frames[framesCount]
+#define DUMP_MAGIC "BRLSFLT1"
+
+namespace brls
+{
+
+static FlightEvent events[BRLS_FLIGHT_RECORDER_EVENTS];
+static std::atomic<uint64_t> nextEvent(0);
+
+static FlightFrame frames[BRLS_FLIGHT_RECORDER_FRAMES];
+static uint64_t nextFrame = 0;
+
+static char dumpPath[256] = BRLS_FLIGHT_RECORDER_PATH;
+
+void FlightRecorder::record(FlightEventType type, uint32_t value, const void* pointer, const char* text)
+{
+    uint64_t index     = nextEvent.fetch_add(1, std::memory_order_relaxed);
+    FlightEvent* event = &events[index & (BRLS_FLIGHT_RECORDER_EVENTS - 1)];
+
+    event->sequence  = 0;
+    event->timestamp = cpu_features_get_time_usec();
+    event->type      = (uint32_t)type;
+    event->value     = value;
+    event->pointer   = (uint64_t)(uintptr_t)pointer;
+
+    if (text)
+    {
+        strncpy(event->text, text, BRLS_FLIGHT_RECORDER_TEXT - 1);
+        event->text[BRLS_FLIGHT_RECORDER_TEXT - 1] = '\0';
+    }
+    else
+    {
+        event->text[0] = '\0';
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+    event->sequence = index + 1;
+}
+
+void FlightRecorder::recordFrame(retro_time_t start, retro_time_t interval, retro_time_t work)
+{
+    FlightFrame* frame = &frames[nextFrame & (BRLS_FLIGHT_RECORDER_FRAMES - 1)];
+
+    frame->timestamp = start;
+    frame->interval  = (uint32_t)interval;
+    frame->work      = (uint32_t)work;
+
+    nextFrame++;
+}
+
+void FlightRecorder::setDumpPath(const char* path)
+{
+    strncpy(dumpPath, path, sizeof(dumpPath) - 1);
+    dumpPath[sizeof(dumpPath) - 1] = '\0';
+}
+
+static bool writeAll(int fd, const void* data, size_t size)
+{
+    const char* bytes = (const char*)data;
+
+    while (size > 0)
+    {
+        ssize_t written = write(fd, bytes, size);
+
+        if (written <= 0)
+            return false;
+
+        bytes += written;
+        size -= written;
+    }
+
+    return true;
+}
+
+bool FlightRecorder::dump()
+{
+    int fd = open(dumpPath, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+
+    if (fd < 0)
+        return false;
+
+    uint32_t sizes[4] = {
+        sizeof(FlightEvent),
+        BRLS_FLIGHT_RECORDER_EVENTS,
+        sizeof(FlightFrame),
+        BRLS_FLIGHT_RECORDER_FRAMES,
+    };
+
+    uint64_t frame = nextFrame;
+
+    bool success = writeAll(fd, DUMP_MAGIC, 8)
+        && writeAll(fd, sizes, sizeof(sizes))
+        && writeAll(fd, &frame, sizeof(frame))
+        && writeAll(fd, events, sizeof(events))
+        && writeAll(fd, frames, sizeof(frames));
+
+    close(fd);
+
+    return success;
+}
+
+const char* FlightRecorder::getDumpPath()
+{
+    return dumpPath;
+}
+
+#ifndef __SWITCH__
+static const int HANDLED_SIGNALS[] = {
+    SIGSEGV,
+    SIGABRT,
+    SIGFPE,
+    SIGILL,
+#ifdef SIGBUS
+    SIGBUS,
+#endif
+};
+
+#define HANDLED_SIGNALS_COUNT (sizeof(HANDLED_SIGNALS) / sizeof(HANDLED_SIGNALS[0]))
+
+// Handlers installed before ours, given the signal back after the dump
+#ifdef _WIN32
+static void (*previousHandlers[HANDLED_SIGNALS_COUNT])(int);
+#else
+static struct sigaction previousActions[HANDLED_SIGNALS_COUNT];
+#endif
+
+static bool signalHandlersInstalled = false;
+
+static void signalHandler(int signal)
+{
+    FlightRecorder::record(FlightEventType::SIGNAL, (uint32_t)signal, nullptr, nullptr);
+    FlightRecorder::dump();
+
+    // Restore the previous handler (the default one if the app did not
+    // install any) and raise again to let it run
+    for (size_t i = 0; i < HANDLED_SIGNALS_COUNT; i++)
+    {
+        if (HANDLED_SIGNALS[i] != signal)
+            continue;
+
+#ifdef _WIN32
+        ::signal(signal, previousHandlers[i]);
+#else
+        sigaction(signal, &previousActions[i], nullptr);
+#endif
+    }
+
+    raise(signal);
+}
+#endif
+
+void FlightRecorder::installSignalHandlers()
+{
+#ifndef __SWITCH__
+    if (signalHandlersInstalled)
+        return;
+
+    for (size_t i = 0; i < HANDLED_SIGNALS_COUNT; i++)
+    {
+#ifdef _WIN32
+        previousHandlers[i] = signal(HANDLED_SIGNALS[i], signalHandler);
+
+        if (previousHandlers[i] == SIG_ERR)
+            previousHandlers[i] = SIG_DFL;
+#else
+        struct sigaction action = {};
+        action.sa_handler       = signalHandler;
+        sigemptyset(&action.sa_mask);
+
+        sigaction(HANDLED_SIGNALS[i], &action, &previousActions[i]);
+#endif
+    }
+
+    signalHandlersInstalled = true;
+#endif
+}
+
+} // namespace brls
@@ -0,0 +1,281 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <string.h>
+
+#include <borealis/gl_audit.hpp>
+#include <borealis/logger.hpp>
+#include <string>
+
+#include <glad.h>
+
+// Audited functions: the ones used by borealis and nanovg, and the synchronous queries
+#define GL_AUDIT_FUNCTIONS(X)            \
+    X(glActiveTexture, false)            \
+    X(glAttachShader, false)             \
+    X(glBindAttribLocation, false)       \
+    X(glBindBuffer, false)               \
+    X(glBindBufferRange, false)          \
+    X(glBindTexture, false)              \
+    X(glBindVertexArray, false)          \
+    X(glBlendFuncSeparate, false)        \
+    X(glBufferData, false)               \
+    X(glBufferStorage, false)            \
+    X(glBufferSubData, false)            \
+    X(glClear, false)                    \
+    X(glClearColor, false)               \
+    X(glClientWaitSync, true)            \
+    X(glColorMask, false)                \
+    X(glCompileShader, false)            \
+    X(glCopyBufferSubData, false)        \
+    X(glCreateProgram, false)            \
+    X(glCreateShader, false)             \
+    X(glCullFace, false)                 \
+    X(glDeleteBuffers, false)            \
+    X(glDeleteProgram, false)            \
+    X(glDeleteShader, false)             \
+    X(glDeleteSync, false)               \
+    X(glDeleteTextures, false)           \
+    X(glDeleteVertexArrays, false)       \
+    X(glDisable, false)                  \
+    X(glDisableVertexAttribArray, false) \
+    X(glDrawArrays, false)               \
+    X(glDrawElements, false)             \
+    X(glEnable, false)                   \
+    X(glEnableVertexAttribArray, false)  \
+    X(glFenceSync, false)                \
+    X(glFinish, true)                    \
+    X(glFlush, false)                    \
+    X(glFrontFace, false)                \
+    X(glGenBuffers, false)               \
+    X(glGenTextures, false)              \
+    X(glGenVertexArrays, false)          \
+    X(glGenerateMipmap, false)           \
+    X(glGetBooleanv, true)               \
+    X(glGetError, true)                  \
+    X(glGetFloatv, true)                 \
+    X(glGetIntegerv, true)               \
+    X(glGetProgramInfoLog, true)         \
+    X(glGetProgramiv, true)              \
+    X(glGetShaderInfoLog, true)          \
+    X(glGetShaderiv, true)               \
+    X(glGetString, true)                 \
+    X(glGetStringi, true)                \
+    X(glGetUniformBlockIndex, true)      \
+    X(glGetUniformLocation, true)        \
+    X(glLinkProgram, false)              \
+    X(glMapBufferRange, false)           \
+    X(glPixelStorei, false)              \
+    X(glReadPixels, true)                \
+    X(glShaderSource, false)             \
+    X(glStencilFunc, false)              \
+    X(glStencilMask, false)              \
+    X(glStencilOp, false)                \
+    X(glStencilOpSeparate, false)        \
+    X(glTexImage2D, false)               \
+    X(glTexParameteri, false)            \
+    X(glTexSubImage2D, false)            \
+    X(glUniform1i, false)                \
+    X(glUniform2fv, false)               \
+    X(glUniform4fv, false)               \
+    X(glUniformBlockBinding, false)      \
+    X(glUnmapBuffer, false)              \
+    X(glUseProgram, false)               \
+    X(glVertexAttribPointer, false)      \
+    X(glViewport, false)
+
+namespace brls
+{
+
+enum GLAuditFunction
+{
+#define X(name, sync) GL_AUDIT_##name,
+    GL_AUDIT_FUNCTIONS(X)
+#undef X
+        GL_AUDIT_FUNCTIONS_COUNT
+};
+
+struct GLAuditFunctionInfo
+{
+    const char* name;
+    bool sync;
+};
+
+static const GLAuditFunctionInfo functions[GL_AUDIT_FUNCTIONS_COUNT] = {
+#define X(name, sync) { #name, sync },
+    GL_AUDIT_FUNCTIONS(X)
+#undef X
+};
+
+static bool installed = false;
+
+static unsigned currentCalls[GL_AUDIT_FUNCTIONS_COUNT];
+static unsigned currentSyncCalls[GL_AUDIT_FUNCTIONS_COUNT];
+static unsigned lastCalls[GL_AUDIT_FUNCTIONS_COUNT];
+static uint64_t totalCalls[GL_AUDIT_FUNCTIONS_COUNT];
+
+static uint64_t frames         = 0;
+static uint64_t syncFrames     = 0; // frames with synchronous calls
+static unsigned lastFrameCalls = 0;
+static unsigned lastFrameSync  = 0;
+
+// One wrapper per function, calling the original glad pointer
+template <int Function, typename R, typename... Args>
+struct GLAuditWrapper
+{
+    inline static R(APIENTRYP original)(Args...) = nullptr;
+
+    static R APIENTRY call(Args... args)
+    {
+        currentCalls[Function]++;
+
+        if constexpr (Function == GL_AUDIT_glClientWaitSync)
+        {
+            // Only a stall if the fence was not signaled yet
+            R result = original(args...);
+            if (result != GL_ALREADY_SIGNALED)
+                currentSyncCalls[Function]++;
+            return result;
+        }
+        else
+        {
+            if (functions[Function].sync)
+                currentSyncCalls[Function]++;
+            return original(args...);
+        }
+    }
+};
+
+template <int Function, typename R, typename... Args>
+static void wrap(R(APIENTRYP* pointer)(Args...))
+{
+    // Not loaded by the driver
+    if (*pointer == nullptr)
+        return;
+
+    GLAuditWrapper<Function, R, Args...>::original = *pointer;
+    *pointer                                       = &GLAuditWrapper<Function, R, Args...>::call;
+}
+
+void GLAudit::install()
+{
+    if (installed)
+        return;
+
+#define X(name, sync) wrap<GL_AUDIT_##name>(&glad_##name);
+    GL_AUDIT_FUNCTIONS(X)
+#undef X
+
+    installed = true;
+
+    Logger::info("GL calls audit enabled");
+}
+
+bool GLAudit::isInstalled()
+{
+    return installed;
+}
+
+void GLAudit::frame()
+{
+    if (!installed)
+        return;
+
+    lastFrameCalls = 0;
+    lastFrameSync  = 0;
+
+    std::string syncList;
+
+    for (int i = 0; i < GL_AUDIT_FUNCTIONS_COUNT; i++)
+    {
+        unsigned calls  = currentCalls[i];
+        unsigned stalls = currentSyncCalls[i];
+
+        lastCalls[i] = calls;
+        totalCalls[i] += calls;
+        lastFrameCalls += calls;
+
+        if (stalls > 0)
+        {
+            lastFrameSync += stalls;
+            syncList += std::string(syncList.empty() ? "" : ", ") + functions[i].name + " x" + std::to_string(stalls);
+        }
+    }
+
+    memset(currentCalls, 0, sizeof(currentCalls));
+    memset(currentSyncCalls, 0, sizeof(currentSyncCalls));
+
+    if (lastFrameSync > 0)
+    {
+        syncFrames++;
+        BRLS_LOG_DEBUG(LogSubsystem::RENDER, "Frame %llu issued %u synchronous GL calls: %s", (unsigned long long)frames, lastFrameSync, syncList.c_str());
+    }
+
+    frames++;
+}
+
+unsigned GLAudit::getLastFrameCalls()
+{
+    return lastFrameCalls;
+}
+
+unsigned GLAudit::getLastFrameSyncCalls()
+{
+    return lastFrameSync;
+}
+
+unsigned GLAudit::getLastFrameCalls(const char* function)
+{
+    for (int i = 0; i < GL_AUDIT_FUNCTIONS_COUNT; i++)
+    {
+        if (strcmp(functions[i].name, function) == 0)
+            return lastCalls[i];
+    }
+
+    return 0;
+}
+
+void GLAudit::logSummary()
+{
+    if (!installed || frames == 0)
+        return;
+
+    uint64_t total = 0;
+    for (int i = 0; i < GL_AUDIT_FUNCTIONS_COUNT; i++)
+        total += totalCalls[i];
+
+    Logger::info("GL calls audit: %llu frames, %.1f calls per frame, %llu frames with synchronous calls",
+        (unsigned long long)frames,
+        (double)total / frames,
+        (unsigned long long)syncFrames);
+
+    for (int i = 0; i < GL_AUDIT_FUNCTIONS_COUNT; i++)
+    {
+        if (totalCalls[i] == 0)
+            continue;
+
+        Logger::info("  %-28s %10llu (%.2f per frame)%s",
+            functions[i].name,
+            (unsigned long long)totalCalls[i],
+            (double)totalCalls[i] / frames,
+            functions[i].sync ? " - synchronous" : "");
+    }
+}
+
+} // namespace brls
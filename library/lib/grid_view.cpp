@@ -0,0 +1,480 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <algorithm>
+#include <borealis/application.hpp>
+#include <borealis/grid_view.hpp>
+#include <borealis/scroll_view.hpp>
+
+namespace brls
+{
+
+GridView::GridView(unsigned cellWidth, unsigned cellHeight)
+    : cellWidth(cellWidth)
+    , cellHeight(cellHeight)
+{
+}
+
+void GridView::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx)
+{
+    for (View* cell : this->cells)
+        cell->frame(ctx);
+}
+
+void GridView::layout(NVGcontext* vg, Style* style, FontStash* stash)
+{
+    this->columns = std::max<size_t>(1, (this->width + this->spacing) / (this->cellWidth + this->spacing));
+
+    // Resize to fit all rows
+    size_t rows = (this->itemsCount + this->columns - 1) / this->columns;
+    this->setHeight(rows > 0 ? rows * (this->cellHeight + this->spacing) - this->spacing : 0);
+
+    this->updateCells(this->focusedIndex);
+}
+
+void GridView::updateCells(size_t requiredIndex)
+{
+    View* focusedCell = this->getFocusedCell();
+
+    // The focus moved away from the pinned cell
+    if (this->pinnedCell && this->pinnedCell != focusedCell)
+        this->releasePinnedCell();
+
+    if (this->itemsCount == 0 || !this->factory)
+    {
+        for (View* cell : this->cells)
+            this->recycleCell(cell);
+
+        this->cells.clear();
+        this->firstIndex = 0;
+        return;
+    }
+
+    int rowHeight = (int)(this->cellHeight + this->spacing);
+    size_t rows   = (this->itemsCount + this->columns - 1) / this->columns;
+
+    // Visible rows, relative to the grid top
+    int top, bottom;
+    this->getViewport(&top, &bottom);
+
+    size_t firstRow = top > 0 ? top / rowHeight : 0;
+    size_t lastRow  = bottom > 0 ? bottom / rowHeight : 0;
+
+    // Prefetched rows
+    firstRow = firstRow > this->prefetchRows ? firstRow - this->prefetchRows : 0;
+    lastRow  = std::min(lastRow + this->prefetchRows, rows - 1);
+    firstRow = std::min(firstRow, lastRow);
+
+    // If the required item is away from the visible rows, the grid
+    // is about to scroll to it: materialize the rows around it instead
+    if (requiredIndex < this->itemsCount)
+    {
+        size_t requiredRow = requiredIndex / this->columns;
+
+        if (requiredRow < firstRow || requiredRow > lastRow)
+        {
+            firstRow = requiredRow > this->prefetchRows ? requiredRow - this->prefetchRows : 0;
+            lastRow  = std::min(requiredRow + this->prefetchRows, rows - 1);
+        }
+    }
+
+    size_t first = firstRow * this->columns;
+    size_t last  = std::min((lastRow + 1) * this->columns, this->itemsCount);
+
+    // Keep the cells still in range, recycle the others
+    this->cellsBuffer.assign(last - first, nullptr);
+
+    for (size_t i = 0; i < this->cells.size(); i++)
+    {
+        size_t index = this->firstIndex + i;
+
+        if (index >= first && index < last)
+        {
+            this->cellsBuffer[index - first] = this->cells[i];
+        }
+        else if (this->cells[i] == focusedCell)
+        {
+            // Still focused, typically when paging away: keep it out of
+            // the recycled cells until the focus actually moves
+            this->releasePinnedCell();
+            this->pinnedCell = focusedCell;
+        }
+        else
+        {
+            this->recycleCell(this->cells[i]);
+        }
+    }
+
+    // Fill the missing ones and place everything
+    for (size_t i = 0; i < this->cellsBuffer.size(); i++)
+    {
+        if (!this->cellsBuffer[i])
+            this->cellsBuffer[i] = this->obtainCell(first + i);
+
+        this->placeCell(this->cellsBuffer[i], first + i);
+    }
+
+    this->cells.swap(this->cellsBuffer);
+    this->firstIndex = first;
+}
+
+void GridView::recycleCell(View* cell)
+{
+    cell->willDisappear(true);
+    this->recycledCells.push_back(cell);
+}
+
+void GridView::releasePinnedCell()
+{
+    if (this->pinnedCell)
+        this->recycleCell(this->pinnedCell);
+
+    this->pinnedCell = nullptr;
+}
+
+void GridView::getViewport(int* top, int* bottom)
+{
+    int viewportTop    = 0;
+    int viewportBottom = (int)Application::contentHeight;
+
+    for (View* view = this->getParent(); view; view = view->getParent())
+    {
+        if (ScrollView* scrollView = dynamic_cast<ScrollView*>(view))
+        {
+            viewportTop    = scrollView->getY();
+            viewportBottom = scrollView->getY() + (int)scrollView->getHeight();
+            break;
+        }
+    }
+
+    *top    = viewportTop - this->y;
+    *bottom = viewportBottom - this->y;
+}
+
+View* GridView::obtainCell(size_t index)
+{
+    View* cell = nullptr;
+
+    if (!this->recycledCells.empty())
+    {
+        cell = this->recycledCells.back();
+        this->recycledCells.pop_back();
+    }
+    else
+    {
+        cell = this->factory();
+        cell->setParent(this);
+    }
+
+    this->binder(cell, index);
+    cell->willAppear(true);
+
+    return cell;
+}
+
+void GridView::placeCell(View* cell, size_t index)
+{
+    size_t row    = index / this->columns;
+    size_t column = index % this->columns;
+
+    cell->setBoundaries(
+        this->x + column * (this->cellWidth + this->spacing),
+        this->y + row * (this->cellHeight + this->spacing),
+        this->cellWidth,
+        this->cellHeight);
+    cell->invalidate();
+}
+
+View* GridView::getCell(size_t index)
+{
+    if (index >= this->itemsCount)
+        return nullptr;
+
+    if (index < this->firstIndex || index >= this->firstIndex + this->cells.size())
+        this->updateCells(index);
+
+    return this->cells[index - this->firstIndex];
+}
+
+View* GridView::focusIndex(size_t index)
+{
+    View* cell = this->getCell(index);
+
+    if (!cell)
+        return nullptr;
+
+    Application::countFocusLookup();
+    return cell->getDefaultFocus();
+}
+
+bool GridView::hasFocusedCell()
+{
+    return this->getFocusedCell() != nullptr;
+}
+
+View* GridView::getFocusedCell()
+{
+    for (View* view = Application::getCurrentFocus(); view; view = view->getParent())
+    {
+        if (view->getParent() == this)
+            return view;
+    }
+
+    return nullptr;
+}
+
+View* GridView::getDefaultFocus()
+{
+    if (this->itemsCount == 0)
+        return nullptr;
+
+    return this->focusIndex(std::min(this->focusedIndex, this->itemsCount - 1));
+}
+
+View* GridView::getNextFocus(FocusDirection direction, View* currentView)
+{
+    size_t index  = this->focusedIndex;
+    size_t column = index % this->columns;
+    size_t row    = index / this->columns;
+    size_t target = index;
+
+    switch (direction)
+    {
+        case FocusDirection::LEFT:
+            if (column == 0)
+                return nullptr;
+            target = index - 1;
+            break;
+        case FocusDirection::RIGHT:
+            if (column == this->columns - 1 || index + 1 >= this->itemsCount)
+                return nullptr;
+            target = index + 1;
+            break;
+        case FocusDirection::UP:
+            if (row == 0)
+                return nullptr;
+            target = index - this->columns;
+            break;
+        case FocusDirection::DOWN:
+            // The last row may be incomplete
+            if (row == (this->itemsCount - 1) / this->columns)
+                return nullptr;
+            target = std::min(index + this->columns, this->itemsCount - 1);
+            break;
+    }
+
+    return this->focusIndex(target);
+}
+
+View* GridView::getNextPageFocus(FocusDirection direction, View* currentFocus)
+{
+    if (direction != FocusDirection::UP && direction != FocusDirection::DOWN)
+        return nullptr;
+
+    int top, bottom;
+    this->getViewport(&top, &bottom);
+
+    size_t pageRows = std::max<int>(1, (bottom - top) / (int)(this->cellHeight + this->spacing));
+    size_t pageSize = pageRows * this->columns;
+    size_t target   = this->focusedIndex;
+
+    if (direction == FocusDirection::UP)
+        target = target >= pageSize ? target - pageSize : target % this->columns;
+    else
+        target = std::min(target + pageSize, this->itemsCount - 1);
+
+    if (target == this->focusedIndex)
+        return nullptr;
+
+    return this->focusIndex(target);
+}
+
+void GridView::onChildFocusGained(View* child)
+{
+    for (size_t i = 0; i < this->cells.size(); i++)
+    {
+        if (this->cells[i] == child)
+        {
+            this->focusedIndex = this->firstIndex + i;
+            break;
+        }
+    }
+
+    if (this->pinnedCell && this->pinnedCell != child)
+        this->releasePinnedCell();
+
+    View::onChildFocusGained(child);
+}
+
+void GridView::willAppear(bool resetState)
+{
+    for (View* cell : this->cells)
+        cell->willAppear(resetState);
+
+    if (this->pinnedCell)
+        this->pinnedCell->willAppear(resetState);
+}
+
+void GridView::willDisappear(bool resetState)
+{
+    for (View* cell : this->cells)
+        cell->willDisappear(resetState);
+
+    if (this->pinnedCell)
+        this->pinnedCell->willDisappear(resetState);
+}
+
+void GridView::onWindowSizeChanged()
+{
+    for (View* cell : this->cells)
+        cell->onWindowSizeChanged();
+
+    if (this->pinnedCell)
+        this->pinnedCell->onWindowSizeChanged();
+
+    this->invalidate();
+}
+
+void GridView::setDataSource(size_t itemsCount, CellFactory factory, CellBinder binder)
+{
+    // Cells made by the previous factory cannot be reused
+    this->deleteCells();
+
+    this->itemsCount   = itemsCount;
+    this->factory      = factory;
+    this->binder       = binder;
+    this->focusedIndex = 0;
+
+    this->notifyFocusabilityChanged();
+    this->invalidate();
+}
+
+void GridView::setItemsCount(size_t itemsCount)
+{
+    this->itemsCount = itemsCount;
+    this->reloadData();
+}
+
+size_t GridView::getItemsCount()
+{
+    return this->itemsCount;
+}
+
+void GridView::reloadData()
+{
+    bool hadFocus = this->hasFocusedCell();
+
+    // Bind the cells again in place, so that the focused one stays focused
+    size_t kept = 0;
+
+    for (size_t i = 0; i < this->cells.size(); i++)
+    {
+        size_t index = this->firstIndex + i;
+
+        if (index < this->itemsCount)
+        {
+            this->binder(this->cells[i], index);
+            kept++;
+        }
+        else
+        {
+            this->recycleCell(this->cells[i]);
+        }
+    }
+
+    this->cells.resize(kept);
+
+    if (this->cells.empty())
+        this->firstIndex = 0;
+
+    // The focused item may be gone
+    if (this->itemsCount > 0 && this->focusedIndex >= this->itemsCount)
+    {
+        this->focusedIndex = this->itemsCount - 1;
+
+        if (hadFocus)
+            Application::giveFocus(this->getDefaultFocus());
+    }
+
+    this->notifyFocusabilityChanged();
+    this->invalidate();
+}
+
+void GridView::setSpacing(unsigned spacing)
+{
+    this->spacing = spacing;
+    this->invalidate();
+}
+
+void GridView::setPrefetchRows(unsigned rows)
+{
+    this->prefetchRows = rows;
+    this->invalidate();
+}
+
+size_t GridView::getColumnsCount()
+{
+    return this->columns;
+}
+
+void GridView::setFocusedIndex(size_t index)
+{
+    if (this->itemsCount == 0)
+        return;
+
+    this->focusedIndex = std::min(index, this->itemsCount - 1);
+
+    if (this->hasFocusedCell())
+        Application::giveFocus(this->getDefaultFocus());
+}
+
+size_t GridView::getFocusedIndex()
+{
+    return this->focusedIndex;
+}
+
+void GridView::deleteCells()
+{
+    for (View* cell : this->cells)
+    {
+        cell->willDisappear(true);
+        delete cell;
+    }
+
+    for (View* cell : this->recycledCells)
+        delete cell;
+
+    if (this->pinnedCell)
+    {
+        this->pinnedCell->willDisappear(true);
+        delete this->pinnedCell;
+    }
+
+    this->pinnedCell = nullptr;
+    this->cells.clear();
+    this->recycledCells.clear();
+    this->firstIndex = 0;
+}
+
+GridView::~GridView()
+{
+    this->deleteCells();
+}
+
+} // namespace brls
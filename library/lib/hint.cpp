@@ -21,7 +21,6 @@
 #include <borealis/application.hpp>
 #include <borealis/hint.hpp>
 #include <borealis/label.hpp>
-#include <set>
 
 namespace brls
 {
@@ -37,16 +36,16 @@ Hint::Hint(bool animate)
     this->setSpacing(style->AppletFrame.footerTextSpacing);
 
     // Subscribe to all events
-    this->globalFocusEventSubscriptor = Application::getGlobalFocusChangeEvent()->subscribe([this](View* newFocus) {
+    this->globalFocusEventSubscriptor = Application::getGlobalFocusChangeEvent()->subscribeScoped([this](View* newFocus) {
         this->rebuildHints();
     });
 
-    this->globalHintsUpdateEventSubscriptor = Application::getGlobalHintsUpdateEvent()->subscribe([this]() {
+    this->globalHintsUpdateEventSubscriptor = Application::getGlobalHintsUpdateEvent()->subscribeScoped([this]() {
         this->rebuildHints();
     });
 }
 
-bool actionsSortFunc(Action a, Action b)
+bool actionsSortFunc(const Action* a, const Action* b)
 {
     // From left to right:
     //  - first +
@@ -54,15 +53,15 @@ bool actionsSortFunc(Action a, Action b)
     //  - finally B and A
 
     // + is before all others
-    if (a.key == Key::PLUS)
+    if (a->key == Key::PLUS)
         return true;
 
     // A is after all others
-    if (b.key == Key::A)
+    if (b->key == Key::A)
         return true;
 
     // B is after all others but A
-    if (b.key == Key::B && a.key != Key::A)
+    if (b->key == Key::B && a->key != Key::A)
         return true;
 
     // Keep original order for the rest
@@ -71,18 +70,16 @@ bool actionsSortFunc(Action a, Action b)
 
 void Hint::rebuildHints()
 {
+    BRLS_PROFILE_SCOPE("Hint::rebuildHints");
+
+    ActionTable* table                  = Application::getActionTable();
+    const std::vector<View*>& focusPath = table->getFocusPath();
+
     // Check if the focused element is still a child of the same parent as the hint view's
     {
-        View* focusParent    = Application::getCurrentFocus();
+        View* focusParent    = focusPath.empty() ? nullptr : focusPath.back();
         View* hintBaseParent = this;
 
-        while (focusParent != nullptr)
-        {
-            if (focusParent->getParent() == nullptr)
-                break;
-            focusParent = focusParent->getParent();
-        }
-
         while (hintBaseParent != nullptr)
         {
             if (hintBaseParent->getParent() == nullptr)
@@ -94,50 +91,86 @@ void Hint::rebuildHints()
             return;
     }
 
-    // Empty the layout and re-populate it with new Labels
-    this->clear(true);
-
-    std::set<Key> addedKeys; // we only ever want one action per key
-    View* focusParent = Application::getCurrentFocus();
+    KeySet addedKeys; // we only ever want one action per key
 
-    // Iterate over the view tree to find all the actions to display
-    std::vector<Action> actions;
+    // Take all the actions to display from the focus path table
+    std::vector<const Action*> actions;
 
-    while (focusParent != nullptr)
+    for (const ActionRef& ref : table->getActions())
     {
-        for (auto& action : focusParent->getActions())
-        {
-            if (action.hidden)
-                continue;
+        const Action& action = ref.get();
 
-            if (addedKeys.find(action.key) != addedKeys.end())
-                continue;
+        if (action.hidden)
+            continue;
 
-            addedKeys.insert(action.key);
-            actions.push_back(action);
-        }
+        if (addedKeys.test((size_t)action.key))
+            continue;
 
-        focusParent = focusParent->getParent();
+        addedKeys.set((size_t)action.key);
+        actions.push_back(&action);
     }
 
     // Sort the actions
     std::stable_sort(actions.begin(), actions.end(), actionsSortFunc);
 
-    // Populate the layout with labels
-    for (Action action : actions)
+    std::vector<std::string> texts;
+    texts.reserve(actions.size());
+
+    for (const Action* action : actions)
+        texts.push_back(Hint::getKeyIcon(action->key) + "  " + action->hintText);
+
+    // Don't touch the layout if the hints didn't change
+    if (texts == this->hintsTexts)
+        return;
+
+    // Update the labels that are still there, only if their text changed
+    size_t kept = std::min(texts.size(), this->getViewsCount());
+
+    for (size_t i = 0; i < kept; i++)
+    {
+        if (texts[i] != this->hintsTexts[i])
+            ((Label*)this->getChild(i))->setText(texts[i]);
+    }
+
+    // Remove the labels we don't need anymore
+    while (this->getViewsCount() > texts.size())
     {
-        std::string hintText = Hint::getKeyIcon(action.key) + "  " + action.hintText;
+        size_t last  = this->getViewsCount() - 1;
+        Label* label = (Label*)this->getChild(last);
+
+        this->removeView(last, false);
+        this->labelsPool.push_back(label);
+    }
+
+    // Add the missing ones, reusing removed labels if possible
+    for (size_t i = kept; i < texts.size(); i++)
+    {
+        Label* label = nullptr;
+
+        if (!this->labelsPool.empty())
+        {
+            label = this->labelsPool.back();
+            this->labelsPool.pop_back();
+            label->setText(texts[i]);
+        }
+        else
+        {
+            label = new Label(LabelStyle::HINT, texts[i]);
+        }
 
-        Label* label = new Label(LabelStyle::HINT, hintText);
         this->addView(label);
     }
+
+    this->hintsTexts = std::move(texts);
 }
 
 Hint::~Hint()
 {
-    // Unregister all events
-    Application::getGlobalFocusChangeEvent()->unsubscribe(this->globalFocusEventSubscriptor);
-    Application::getGlobalHintsUpdateEvent()->unsubscribe(this->globalHintsUpdateEventSubscriptor);
+    // Events are unregistered by the scoped subscriptions
+
+    // Labels still in the layout are freed by ~BoxLayout()
+    for (Label* label : this->labelsPool)
+        delete label;
 }
 
 std::string Hint::getKeyIcon(Key key)
@@ -106,6 +106,8 @@ void Image::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height,
 
 void Image::reloadTexture()
 {
+    BRLS_PROFILE_SCOPE("Image::reloadTexture");
+
     NVGcontext* vg = Application::getNVGContext();
 
     if (this->texture != -1)
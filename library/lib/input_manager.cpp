@@ -0,0 +1,96 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <math.h>
+
+#include <borealis/clock.hpp>
+#include <borealis/input_manager.hpp>
+
+namespace brls
+{
+
+retro_time_t KeyRepeatCurve::getInterval(retro_time_t repeatingTime) const
+{
+    float progress = 1.0f;
+
+    if (this->accelerationTime > 0)
+        progress = fminf((float)repeatingTime / (float)(this->accelerationTime * 1000), 1.0f);
+
+    float interval = (float)this->startInterval + ((float)this->endInterval - (float)this->startInterval) * powf(progress, this->exponent);
+
+    return (retro_time_t)(fmaxf(interval, 1.0f) * 1000);
+}
+
+InputManager::InputManager(GLFWwindow* window)
+    : window(window)
+{
+}
+
+void InputManager::sample()
+{
+    GLFWgamepadstate state = {};
+
+    if (!glfwGetGamepadState(GLFW_JOYSTICK_1, &state))
+    {
+        // Keyboard -> DPAD Mapping
+        state.buttons[GLFW_GAMEPAD_BUTTON_DPAD_LEFT]    = glfwGetKey(this->window, GLFW_KEY_LEFT);
+        state.buttons[GLFW_GAMEPAD_BUTTON_DPAD_RIGHT]   = glfwGetKey(this->window, GLFW_KEY_RIGHT);
+        state.buttons[GLFW_GAMEPAD_BUTTON_DPAD_UP]      = glfwGetKey(this->window, GLFW_KEY_UP);
+        state.buttons[GLFW_GAMEPAD_BUTTON_DPAD_DOWN]    = glfwGetKey(this->window, GLFW_KEY_DOWN);
+        state.buttons[GLFW_GAMEPAD_BUTTON_START]        = glfwGetKey(this->window, GLFW_KEY_ESCAPE);
+        state.buttons[GLFW_GAMEPAD_BUTTON_BACK]         = glfwGetKey(this->window, GLFW_KEY_F1);
+        state.buttons[GLFW_GAMEPAD_BUTTON_A]            = glfwGetKey(this->window, GLFW_KEY_ENTER);
+        state.buttons[GLFW_GAMEPAD_BUTTON_B]            = glfwGetKey(this->window, GLFW_KEY_BACKSPACE);
+        state.buttons[GLFW_GAMEPAD_BUTTON_LEFT_BUMPER]  = glfwGetKey(this->window, GLFW_KEY_L);
+        state.buttons[GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER] = glfwGetKey(this->window, GLFW_KEY_R);
+    }
+
+    retro_time_t timestamp = Clock::getTimeUsec();
+
+    for (int i = GLFW_GAMEPAD_BUTTON_A; i <= GLFW_GAMEPAD_BUTTON_LAST; i++)
+    {
+        if (state.buttons[i] == this->sampledState.buttons[i])
+            continue;
+
+        this->pushEvent({ i, state.buttons[i] == GLFW_PRESS, timestamp });
+    }
+
+    this->sampledState = state;
+}
+
+void InputManager::pushEvent(InputEvent event)
+{
+    std::lock_guard<std::mutex> lock(this->eventsMutex);
+    this->events.push_back(event);
+}
+
+void InputManager::drainEvents(std::vector<InputEvent>* events)
+{
+    std::lock_guard<std::mutex> lock(this->eventsMutex);
+    events->insert(events->end(), this->events.begin(), this->events.end());
+    this->events.clear();
+}
+
+bool InputManager::hasPendingEvents()
+{
+    std::lock_guard<std::mutex> lock(this->eventsMutex);
+    return !this->events.empty();
+}
+
+} // namespace brls
@@ -0,0 +1,238 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <string.h>
+
+#include <algorithm>
+#include <borealis/input_recorder.hpp>
+#include <borealis/logger.hpp>
+
+// Recording layout, all little endian:
+//   char magic[8] "BRLSINP1"
+//   uint32 frameSize, buttonsCount
+//   InputFrame frames[] until the end of the file
+#define RECORDING_MAGIC "BRLSINP1"
+#define RECORDING_BUTTONS (GLFW_GAMEPAD_BUTTON_LAST + 1)
+
+namespace brls
+{
+
+InputRecorder::~InputRecorder()
+{
+    this->stop();
+}
+
+bool InputRecorder::start(std::string path)
+{
+    this->stop();
+
+    this->file = fopen(path.c_str(), "wb");
+    if (!this->file)
+    {
+        BRLS_LOG_ERROR(LogSubsystem::INPUT, "Cannot open %s to record inputs", path.c_str());
+        return false;
+    }
+
+    uint32_t header[2] = { sizeof(InputFrame), RECORDING_BUTTONS };
+
+    fwrite(RECORDING_MAGIC, 1, 8, this->file);
+    fwrite(header, sizeof(header), 1, this->file);
+
+    this->frames = 0;
+
+    BRLS_LOG_INFO(LogSubsystem::INPUT, "Recording inputs to %s", path.c_str());
+    return true;
+}
+
+void InputRecorder::stop()
+{
+    if (!this->file)
+        return;
+
+    fclose(this->file);
+    this->file = nullptr;
+
+    BRLS_LOG_INFO(LogSubsystem::INPUT, "Recorded %llu frames of inputs", (unsigned long long)this->frames);
+}
+
+bool InputRecorder::isRecording()
+{
+    return this->file != nullptr;
+}
+
+void InputRecorder::recordFrame(retro_time_t time, GLFWgamepadstate* state)
+{
+    if (!this->file)
+        return;
+
+    InputFrame frame = {};
+    frame.time       = time;
+
+    for (int button = 0; button < RECORDING_BUTTONS; button++)
+    {
+        if (state->buttons[button] == GLFW_PRESS)
+            frame.buttons |= 1u << button;
+    }
+
+    fwrite(&frame, sizeof(frame), 1, this->file);
+    this->frames++;
+}
+
+bool InputReplayer::load(std::string path)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        BRLS_LOG_ERROR(LogSubsystem::INPUT, "Cannot open inputs recording %s", path.c_str());
+        return false;
+    }
+
+    char magic[8];
+    uint32_t header[2];
+
+    if (fread(magic, 1, 8, file) != 8 || memcmp(magic, RECORDING_MAGIC, 8) != 0
+        || fread(header, sizeof(header), 1, file) != 1
+        || header[0] != sizeof(InputFrame) || header[1] != RECORDING_BUTTONS)
+    {
+        BRLS_LOG_ERROR(LogSubsystem::INPUT, "%s is not an inputs recording, or from another version", path.c_str());
+        fclose(file);
+        return false;
+    }
+
+    this->frames.clear();
+
+    InputFrame frame;
+    while (fread(&frame, sizeof(frame), 1, file) == 1)
+        this->frames.push_back(frame);
+
+    fclose(file);
+
+    this->current = 0;
+    this->buttons = 0;
+
+    this->frameTimes.clear();
+    this->frameTimes.reserve(this->frames.size());
+    this->layouts   = 0;
+    this->drawCalls = 0;
+
+    BRLS_LOG_INFO(LogSubsystem::INPUT, "Replaying %zu frames of inputs from %s", this->frames.size(), path.c_str());
+    return !this->frames.empty();
+}
+
+bool InputReplayer::isReplaying()
+{
+    return !this->frames.empty();
+}
+
+bool InputReplayer::isFinished()
+{
+    return this->current >= this->frames.size();
+}
+
+bool InputReplayer::nextFrame()
+{
+    if (this->isFinished())
+        return false;
+
+    this->current++;
+    return true;
+}
+
+void InputReplayer::pushEvents(InputManager* inputManager)
+{
+    if (this->current == 0)
+        return;
+
+    InputFrame* frame = &this->frames[this->current - 1];
+    uint32_t changed  = frame->buttons ^ this->buttons;
+
+    for (int button = 0; button < RECORDING_BUTTONS; button++)
+    {
+        if (changed & (1u << button))
+            inputManager->pushEvent({ button, (frame->buttons & (1u << button)) != 0, frame->time });
+    }
+
+    this->buttons = frame->buttons;
+}
+
+retro_time_t InputReplayer::getTime()
+{
+    if (this->frames.empty())
+        return 0;
+
+    // Stay on the first frame until the replay starts, and on the last one once it's over
+    size_t index = std::min(std::max(this->current.load(), (size_t)1), this->frames.size()) - 1;
+    return this->frames[index].time;
+}
+
+size_t InputReplayer::getFramesCount()
+{
+    return this->frames.size();
+}
+
+void InputReplayer::recordFrameStats(retro_time_t frameTime, uint64_t layouts, uint64_t drawCalls)
+{
+    this->frameTimes.push_back(frameTime);
+    this->layouts += layouts;
+    this->drawCalls += drawCalls;
+}
+
+bool InputReplayer::writeReport(std::string path)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file)
+    {
+        BRLS_LOG_ERROR(LogSubsystem::INPUT, "Cannot open %s to write the replay report", path.c_str());
+        return false;
+    }
+
+    std::vector<retro_time_t> sorted = this->frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+
+    size_t count = sorted.size();
+
+    double sum = 0.0;
+    for (retro_time_t time : sorted)
+        sum += time;
+
+    auto percentile = [&sorted, count](unsigned p) { return count ? sorted[std::min(count - 1, count * p / 100)] / 1000.0 : 0.0; };
+
+    retro_time_t duration = count ? this->frames[count - 1].time - this->frames[0].time : 0;
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"recorded_frames\": %zu,\n", this->frames.size());
+    fprintf(file, "  \"replayed_frames\": %zu,\n", count);
+    fprintf(file, "  \"recorded_duration_ms\": %.3f,\n", duration / 1000.0);
+    fprintf(file, "  \"frame_ms\": { \"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+        count ? sum / count / 1000.0 : 0.0,
+        percentile(50),
+        percentile(90),
+        percentile(99),
+        count ? sorted.back() / 1000.0 : 0.0);
+    fprintf(file, "  \"layouts\": %llu,\n", (unsigned long long)this->layouts);
+    fprintf(file, "  \"draw_calls\": %llu\n", (unsigned long long)this->drawCalls);
+    fprintf(file, "}\n");
+
+    fclose(file);
+
+    BRLS_LOG_INFO(LogSubsystem::INPUT, "Replay report written to %s", path.c_str());
+    return true;
+}
+
+} // namespace brls
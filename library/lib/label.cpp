@@ -89,6 +89,8 @@ void Label::setFontSize(unsigned size)
 
 void Label::setText(std::string text)
 {
+    BRLS_ASSERT_MAIN_THREAD();
+
     this->text = text;
 
     if (this->hasParent())
@@ -64,6 +64,9 @@ void LayerView::changeLayer(int index, bool focus)
         });
 
         this->layers[index]->invalidate();
+
+        // The new layer may not have the same focusability as the old one
+        this->notifyFocusabilityChanged();
     }
 
     if (index == -1)
@@ -75,6 +78,7 @@ void LayerView::changeLayer(int index, bool focus)
         }
 
         this->selectedIndex = index;
+        this->notifyFocusabilityChanged();
     }
 }
 
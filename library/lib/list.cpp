@@ -17,8 +17,10 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <ctype.h>
 #include <math.h>
 
+#include <algorithm>
 #include <borealis/animations.hpp>
 #include <borealis/application.hpp>
 #include <borealis/dropdown.hpp>
@@ -43,6 +45,11 @@ ListContentView::ListContentView(List* list, size_t defaultFocus)
     this->setRememberFocus(true);
 }
 
+List* ListContentView::getList()
+{
+    return this->list;
+}
+
 void ListContentView::customSpacing(View* current, View* next, int* spacing)
 {
     // Don't add spacing to the first list item
@@ -438,6 +445,14 @@ bool ListItem::hasDescription()
     return this->descriptionView;
 }
 
+void ListItem::setLabel(std::string label)
+{
+    this->label = label;
+
+    if (ListContentView* content = dynamic_cast<ListContentView*>(this->getParent()))
+        content->getList()->invalidateLettersIndex();
+}
+
 std::string ListItem::getLabel()
 {
     return this->label;
@@ -579,6 +594,28 @@ List::List(size_t defaultFocus)
 void List::addView(View* view, bool fill)
 {
     this->layout->addView(view, fill);
+    this->lettersIndexDirty = true;
+}
+
+void List::addViews(const std::vector<View*>& views, bool fill)
+{
+    this->layout->addViews(views, fill);
+    this->lettersIndexDirty = true;
+}
+
+void List::reserve(size_t count)
+{
+    this->layout->reserve(count);
+}
+
+void List::setBuilderMode(bool builderMode)
+{
+    this->layout->setBuilderMode(builderMode);
+}
+
+bool List::jumpToIndex(size_t index)
+{
+    return this->layout->jumpToIndex(index);
 }
 
 void List::setMargins(unsigned top, unsigned right, unsigned bottom, unsigned left)
@@ -610,6 +647,67 @@ void List::customSpacing(View* current, View* next, int* spacing)
     // Nothing to do by default
 }
 
+void List::buildLettersIndex()
+{
+    this->lettersIndex.clear();
+
+    for (size_t i = 0; i < this->layout->getViewsCount(); i++)
+    {
+        if (ListItem* item = dynamic_cast<ListItem*>(this->layout->getChild(i)))
+        {
+            std::string label = item->getLabel();
+
+            if (!label.empty())
+                this->lettersIndex.push_back(std::make_pair((char)toupper((unsigned char)label[0]), i));
+        }
+    }
+
+    std::sort(this->lettersIndex.begin(), this->lettersIndex.end());
+
+    this->lettersIndexDirty = false;
+}
+
+bool List::jumpToLetter(char letter)
+{
+    std::pair<char, size_t> key = std::make_pair((char)toupper((unsigned char)letter), (size_t)0);
+
+    if (this->lettersIndexDirty)
+        this->buildLettersIndex();
+
+    auto it = std::lower_bound(this->lettersIndex.begin(), this->lettersIndex.end(), key);
+
+    // The children may have been changed behind our back, check
+    // that the target still matches and rebuild the index if not
+    if (it != this->lettersIndex.end() && !this->matchesLetter(it->second, it->first))
+    {
+        this->buildLettersIndex();
+        it = std::lower_bound(this->lettersIndex.begin(), this->lettersIndex.end(), key);
+    }
+
+    if (it == this->lettersIndex.end())
+        return false;
+
+    return this->layout->jumpToIndex(it->second);
+}
+
+bool List::matchesLetter(size_t index, char letter)
+{
+    if (index >= this->layout->getViewsCount())
+        return false;
+
+    ListItem* item = dynamic_cast<ListItem*>(this->layout->getChild(index));
+    if (!item)
+        return false;
+
+    std::string label = item->getLabel();
+    return !label.empty() && toupper((unsigned char)label[0]) == (unsigned char)letter;
+}
+
+void List::invalidateLettersIndex()
+{
+    this->lettersIndexDirty = true;
+}
+
 List::~List()
 {
     // ScrollView already deletes the content view
@@ -20,53 +20,230 @@
 #include <stdarg.h>
 #include <stdio.h>
 
+#include <atomic>
+#include <borealis/flight_recorder.hpp>
 #include <borealis/logger.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define LOG_BUFFER_SIZE 512 // lines, must be a power of two
+#define LOG_LINE_MAX 256
+#define LOG_FLUSH_PERIOD 10 // ms
 
 namespace brls
 {
 
-static LogLevel g_logLevel = LogLevel::INFO;
+static const char* LEVEL_PREFIXES[] = { "ERROR", "INFO", "DEBUG" };
+static const char* LEVEL_COLORS[]   = { "[0;31m", "[0;34m", "[0;32m" };
+
+static const char* SUBSYSTEM_NAMES[BRLS_LOG_SUBSYSTEMS] = { "", "focus", "views", "input", "tasks", "render" };
+
+struct LogSlot
+{
+    std::atomic<size_t> sequence;
+    LogLevel level;
+    LogSubsystem subsystem;
+    char text[LOG_LINE_MAX];
+};
+
+// Bounded MPMC ring (Vyukov): producers claim a slot with a CAS, format
+// in place and publish it by bumping its sequence number
+class LogBuffer
+{
+  private:
+    LogSlot slots[LOG_BUFFER_SIZE];
+
+    std::atomic<size_t> enqueuePosition;
+    size_t dequeuePosition = 0; // protected by consumerMutex
+    size_t reportedDropped = 0; // same
+
+    std::mutex consumerMutex;
+
+    std::thread thread;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+
+  public:
+    std::atomic<size_t> droppedLines;
+
+    LogBuffer()
+        : enqueuePosition(0)
+        , droppedLines(0)
+    {
+        for (size_t i = 0; i < LOG_BUFFER_SIZE; i++)
+            this->slots[i].sequence.store(i, std::memory_order_relaxed);
+
+        this->thread = std::thread(&LogBuffer::threadLoop, this);
+    }
+
+    void push(LogSubsystem subsystem, LogLevel level, const char* format, va_list ap)
+    {
+        size_t position = this->enqueuePosition.load(std::memory_order_relaxed);
+        LogSlot* slot;
+
+        while (true)
+        {
+            slot            = &this->slots[position & (LOG_BUFFER_SIZE - 1)];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff   = (intptr_t)sequence - (intptr_t)position;
+
+            if (diff == 0)
+            {
+                if (this->enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // Full
+                this->droppedLines++;
+                return;
+            }
+            else
+            {
+                position = this->enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->level     = level;
+        slot->subsystem = subsystem;
+        vsnprintf(slot->text, LOG_LINE_MAX, format, ap);
+
+        FlightRecorder::record(FlightEventType::LOG, (uint32_t)level, nullptr, slot->text);
+
+        slot->sequence.store(position + 1, std::memory_order_release);
+
+        // Errors usually come right before things go wrong
+        if (level == LogLevel::ERROR)
+            this->wakeCondition.notify_one();
+    }
+
+    void flush()
+    {
+        std::lock_guard<std::mutex> lock(this->consumerMutex);
+
+        bool written = false;
+
+        while (true)
+        {
+            LogSlot* slot = &this->slots[this->dequeuePosition & (LOG_BUFFER_SIZE - 1)];
+
+            if (slot->sequence.load(std::memory_order_acquire) != this->dequeuePosition + 1)
+                break;
+
+            const char* subsystem = SUBSYSTEM_NAMES[(int)slot->subsystem];
+
+            if (subsystem[0] != '\0')
+                printf("\033%s[%s]\033[0m [%s] %s\n", LEVEL_COLORS[(int)slot->level], LEVEL_PREFIXES[(int)slot->level], subsystem, slot->text);
+            else
+                printf("\033%s[%s]\033[0m %s\n", LEVEL_COLORS[(int)slot->level], LEVEL_PREFIXES[(int)slot->level], slot->text);
+
+            slot->sequence.store(this->dequeuePosition + LOG_BUFFER_SIZE, std::memory_order_release);
+            this->dequeuePosition++;
+
+            written = true;
+        }
+
+        size_t dropped = this->droppedLines;
+        if (dropped != this->reportedDropped)
+        {
+            printf("\033%s[%s]\033[0m %zu log lines dropped\n", LEVEL_COLORS[0], LEVEL_PREFIXES[0], dropped - this->reportedDropped);
+            this->reportedDropped = dropped;
+            written               = true;
+        }
+
+        if (written)
+            fflush(stdout);
+    }
+
+  private:
+    void threadLoop()
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(this->wakeMutex);
+                this->wakeCondition.wait_for(lock, std::chrono::milliseconds(LOG_FLUSH_PERIOD));
+            }
+
+            this->flush();
+        }
+    }
+};
+
+// Never deleted, so that logging from static destructors (or from threads
+// still running at exit) keeps working: Application::exit() flushes it
+static LogBuffer* getLogBuffer()
+{
+    static LogBuffer* buffer = new LogBuffer();
+    return buffer;
+}
 
 void Logger::setLogLevel(LogLevel newLogLevel)
 {
-    g_logLevel = newLogLevel;
+    for (size_t i = 0; i < BRLS_LOG_SUBSYSTEMS; i++)
+        Logger::levels[i].store(newLogLevel, std::memory_order_relaxed);
 }
 
-void Logger::log(LogLevel logLevel, const char* prefix, const char* color, const char* format, va_list ap)
+void Logger::setLogLevel(LogSubsystem subsystem, LogLevel newLogLevel)
 {
-    if (g_logLevel < logLevel)
-        return;
+    Logger::levels[(int)subsystem].store(newLogLevel, std::memory_order_relaxed);
+}
 
-    printf("\033%s[%s]\033[0m ", color, prefix);
-    vprintf(format, ap);
-    printf("\n");
+void Logger::log(LogSubsystem subsystem, LogLevel logLevel, const char* format, va_list ap)
+{
+    getLogBuffer()->push(subsystem, logLevel, format, ap);
+}
 
-#ifdef __MINGW32__
-    fflush(0);
-#endif
+void Logger::write(LogSubsystem subsystem, LogLevel logLevel, const char* format, ...)
+{
+    va_list ap;
+    va_start(ap, format);
+    Logger::log(subsystem, logLevel, format, ap);
+    va_end(ap);
+}
+
+void Logger::flush()
+{
+    getLogBuffer()->flush();
+}
+
+size_t Logger::getDroppedLines()
+{
+    return getLogBuffer()->droppedLines;
 }
 
 void Logger::error(const char* format, ...)
 {
+    if (!Logger::isEnabled(LogSubsystem::GENERAL, LogLevel::ERROR))
+        return;
+
     va_list ap;
     va_start(ap, format);
-    Logger::log(LogLevel::ERROR, "ERROR", "[0;31m", format, ap);
+    Logger::log(LogSubsystem::GENERAL, LogLevel::ERROR, format, ap);
     va_end(ap);
 }
 
 void Logger::info(const char* format, ...)
 {
+    if (!Logger::isEnabled(LogSubsystem::GENERAL, LogLevel::INFO))
+        return;
+
     va_list ap;
     va_start(ap, format);
-    Logger::log(LogLevel::INFO, "INFO", "[0;34m", format, ap);
+    Logger::log(LogSubsystem::GENERAL, LogLevel::INFO, format, ap);
     va_end(ap);
 }
 
 void Logger::debug(const char* format, ...)
 {
+    if (!Logger::isEnabled(LogSubsystem::GENERAL, LogLevel::DEBUG))
+        return;
+
     va_list ap;
     va_start(ap, format);
-    Logger::log(LogLevel::DEBUG, "DEBUG", "[0;32m", format, ap);
+    Logger::log(LogSubsystem::GENERAL, LogLevel::DEBUG, format, ap);
     va_end(ap);
 }
 
@@ -0,0 +1,149 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <borealis/main_thread_queue.hpp>
+#include <unordered_set>
+
+namespace brls
+{
+
+MainThreadQueue::MainThreadQueue()
+{
+    this->stub.next = nullptr;
+    this->head      = &this->stub;
+    this->tail      = &this->stub;
+}
+
+void MainThreadQueue::pushNode(Node* node)
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+
+    Node* previous = this->head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+void MainThreadQueue::push(std::function<void(void)> work, const void* key)
+{
+    Node* node = new Node();
+    node->work = work;
+    node->key  = key;
+
+    this->pushNode(node);
+}
+
+MainThreadQueue::Node* MainThreadQueue::pop()
+{
+    Node* tail = this->tail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &this->stub)
+    {
+        if (!next)
+            return nullptr;
+
+        this->tail = next;
+        tail       = next;
+        next       = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next)
+    {
+        this->tail = next;
+        return tail;
+    }
+
+    // A producer is between its exchange and its store, try again next time
+    if (tail != this->head.load(std::memory_order_acquire))
+        return nullptr;
+
+    // tail is the last node: put the stub back behind it to pop it
+    this->pushNode(&this->stub);
+
+    next = tail->next.load(std::memory_order_acquire);
+    if (next)
+    {
+        this->tail = next;
+        return tail;
+    }
+
+    return nullptr;
+}
+
+size_t MainThreadQueue::dispatch(retro_time_t budget)
+{
+    // Take everything published so far
+    bool keyed = false;
+    while (Node* node = this->pop())
+    {
+        keyed |= node->key != nullptr;
+        this->pending.push_back(node);
+    }
+
+    // Only keep the latest closure of every key
+    if (keyed)
+    {
+        std::unordered_set<const void*> keys;
+        for (auto it = this->pending.rbegin(); it != this->pending.rend(); it++)
+        {
+            Node* node = *it;
+
+            if (!node || !node->key)
+                continue;
+
+            if (!keys.insert(node->key).second)
+            {
+                delete node;
+                *it = nullptr;
+            }
+        }
+    }
+
+    // Run them
+    size_t count       = 0;
+    retro_time_t start = cpu_features_get_time_usec();
+
+    while (!this->pending.empty())
+    {
+        Node* node = this->pending.front();
+        this->pending.pop_front();
+
+        if (!node)
+            continue;
+
+        node->work();
+        delete node;
+        count++;
+
+        if (cpu_features_get_time_usec() - start >= budget)
+            break;
+    }
+
+    return count;
+}
+
+MainThreadQueue::~MainThreadQueue()
+{
+    for (Node* node : this->pending)
+        delete node;
+
+    while (Node* node = this->pop())
+        delete node;
+}
+
+} // namespace brls
@@ -87,7 +87,6 @@ void NotificationManager::notify(std::string text)
     menu_timer_ctx_entry_t entry;
 
     entry.duration = Application::getStyle()->AnimationDuration.notificationTimeout;
-    entry.tick     = [](void*) {};
     entry.userdata = nullptr;
     entry.cb       = [this, notification, i](void* userdata) {
         notification->hide([this, notification, i]() {
@@ -0,0 +1,190 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cxxabi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <borealis/logger.hpp>
+#include <borealis/profiler.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define MAX_ZONES_PER_THREAD (1 << 20)
+
+namespace brls
+{
+
+struct ProfileZone
+{
+    const char* name;
+    const char* detail;
+    retro_time_t start;
+    retro_time_t duration;
+};
+
+// Only written by its thread, read when writing the trace
+struct ProfileThread
+{
+    unsigned id;
+    std::string name;
+    std::vector<ProfileZone> zones;
+    size_t dropped = 0;
+};
+
+static std::mutex threadsMutex;
+static std::vector<std::unique_ptr<ProfileThread>> threads;
+static std::string tracePath;
+
+static thread_local ProfileThread* currentThread = nullptr;
+
+static ProfileThread* getCurrentThread()
+{
+    if (!currentThread)
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+
+        threads.emplace_back(new ProfileThread());
+        currentThread     = threads.back().get();
+        currentThread->id = threads.size();
+    }
+
+    return currentThread;
+}
+
+void Profiler::start(std::string path)
+{
+    tracePath = path;
+    Profiler::enabled.store(true, std::memory_order_relaxed);
+
+    Logger::info("Profiler started, the trace will be written to %s", path.c_str());
+}
+
+void Profiler::setThreadName(std::string name)
+{
+    getCurrentThread()->name = name;
+}
+
+void Profiler::record(const char* name, const char* detail, retro_time_t start, retro_time_t end)
+{
+    ProfileThread* thread = getCurrentThread();
+
+    if (thread->zones.size() >= MAX_ZONES_PER_THREAD)
+    {
+        thread->dropped++;
+        return;
+    }
+
+    thread->zones.push_back({ name, detail, start, end - start });
+}
+
+static void writeString(FILE* file, const char* string)
+{
+    fputc('"', file);
+
+    for (const char* c = string; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            fputc('\\', file);
+
+        if ((unsigned char)*c >= 0x20)
+            fputc(*c, file);
+    }
+
+    fputc('"', file);
+}
+
+// Writes the detail, demangled if it's a type name
+static void writeDetail(FILE* file, const char* detail)
+{
+    int status      = -1;
+    char* demangled = abi::__cxa_demangle(detail, nullptr, nullptr, &status);
+
+    writeString(file, status == 0 && demangled ? demangled : detail);
+
+    free(demangled);
+}
+
+bool Profiler::stop()
+{
+    if (!Profiler::enabled.exchange(false, std::memory_order_relaxed))
+        return true;
+
+    FILE* file = fopen(tracePath.c_str(), "w");
+
+    if (!file)
+    {
+        Logger::error("Cannot write the trace to %s", tracePath.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(threadsMutex);
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    bool first   = true;
+    size_t zones = 0;
+
+    for (std::unique_ptr<ProfileThread>& thread : threads)
+    {
+        if (!thread->name.empty())
+        {
+            fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", thread->id);
+            writeString(file, thread->name.c_str());
+            fprintf(file, "}}");
+            first = false;
+        }
+
+        for (ProfileZone& zone : thread->zones)
+        {
+            fprintf(file, "%s{\"ph\":\"X\",\"cat\":\"borealis\",\"pid\":1,\"tid\":%u,\"ts\":%lld,\"dur\":%lld,\"name\":",
+                first ? "" : ",\n", thread->id, (long long)zone.start, (long long)zone.duration);
+            writeString(file, zone.name);
+
+            if (zone.detail)
+            {
+                fprintf(file, ",\"args\":{\"detail\":");
+                writeDetail(file, zone.detail);
+                fprintf(file, "}");
+            }
+
+            fprintf(file, "}");
+            first = false;
+        }
+
+        zones += thread->zones.size();
+
+        if (thread->dropped > 0)
+            Logger::error("Profiler: %zu zones dropped on thread %u", thread->dropped, thread->id);
+
+        thread->zones.clear();
+        thread->zones.shrink_to_fit();
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    Logger::info("Trace written to %s (%zu zones)", tracePath.c_str(), zones);
+
+    return true;
+}
+
+} // namespace brls
@@ -17,52 +17,236 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <stdio.h>
+
 #include <borealis/application.hpp>
+#include <borealis/clock.hpp>
 #include <borealis/progress_display.hpp>
 
+#define THROUGHPUT_WINDOW 500 // ms
+#define THROUGHPUT_SMOOTHING 0.3f // weight of the last window
+
 namespace brls
 {
 
+ProgressSource::ProgressSource(uint64_t total)
+    : current(0)
+    , total(total)
+{
+}
+
+void ProgressSource::setTotal(uint64_t total)
+{
+    this->total.store(total, std::memory_order_relaxed);
+}
+
+void ProgressSource::setProgress(uint64_t current)
+{
+    this->current.store(current, std::memory_order_relaxed);
+}
+
+void ProgressSource::advance(uint64_t delta)
+{
+    this->current.fetch_add(delta, std::memory_order_relaxed);
+}
+
+uint64_t ProgressSource::getProgress()
+{
+    return this->current.load(std::memory_order_relaxed);
+}
+
+uint64_t ProgressSource::getTotal()
+{
+    return this->total.load(std::memory_order_relaxed);
+}
+
+static std::string formatThroughput(float bytesPerSecond)
+{
+    static const char* units[] = { "B/s", "KB/s", "MB/s", "GB/s" };
+
+    size_t unit = 0;
+    while (bytesPerSecond >= 1024.0f && unit < 3)
+    {
+        bytesPerSecond /= 1024.0f;
+        unit++;
+    }
+
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.1f %s", bytesPerSecond, units[unit]);
+    return std::string(buffer);
+}
+
+static std::string formatDuration(int seconds)
+{
+    char buffer[32];
+
+    if (seconds >= 3600)
+        snprintf(buffer, sizeof(buffer), "%d:%02d:%02d", seconds / 3600, (seconds / 60) % 60, seconds % 60);
+    else
+        snprintf(buffer, sizeof(buffer), "%d:%02d", seconds / 60, seconds % 60);
+
+    return std::string(buffer);
+}
+
 ProgressDisplay::ProgressDisplay(ProgressDisplayFlags progressFlags)
+    : flags(progressFlags)
 {
     if (progressFlags & ProgressDisplayFlags::PERCENTAGE)
         this->label = new Label(LabelStyle::DIALOG, "0%", false);
     if (progressFlags & ProgressDisplayFlags::SPINNER)
         this->spinner = new ProgressSpinner();
+    if (progressFlags & (ProgressDisplayFlags::THROUGHPUT | ProgressDisplayFlags::ETA))
+    {
+        this->readoutLabel = new Label(LabelStyle::DESCRIPTION, "", false);
+        this->readoutLabel->setHorizontalAlign(NVG_ALIGN_CENTER);
+    }
 }
 
 void ProgressDisplay::setProgress(int current, int max)
+{
+    BRLS_ASSERT_MAIN_THREAD();
+
+    if (current < 0 || max <= 0)
+        return;
+
+    this->updatePercentage(current, max);
+}
+
+void ProgressDisplay::updatePercentage(uint64_t current, uint64_t max)
 {
     if (current > max)
         return;
 
-    this->progressPercentage = ((current * 100) / max);
+    this->progressPercentage = max > 0 ? (float)current * 100.0f / (float)max : 0.0f;
+
+    // Only format the text when the displayed value changes
+    int percentage = (int)this->progressPercentage;
 
-    if (!this->label)
+    if (!this->label || percentage == this->displayedPercentage)
         return;
 
-    std::string labelText = std::to_string((unsigned)this->progressPercentage);
+    this->displayedPercentage = percentage;
+
+    std::string labelText = std::to_string(percentage);
     labelText += "%";
     this->label->setText(labelText);
 }
 
+void ProgressDisplay::setSource(ProgressSource* source)
+{
+    this->source      = source;
+    this->windowStart = 0;
+    this->throughput  = 0.0f;
+
+    if (this->readoutLabel)
+        this->readoutLabel->setText("");
+}
+
+void ProgressDisplay::sampleSource()
+{
+    uint64_t current = this->source->getProgress();
+
+    this->updatePercentage(current, this->source->getTotal());
+
+    if (!this->readoutLabel)
+        return;
+
+    // Measure the throughput over fixed windows
+    retro_time_t now = Clock::getTimeMs();
+
+    if (this->windowStart == 0 || current < this->windowProgress)
+    {
+        this->windowStart    = now;
+        this->windowProgress = current;
+        this->throughput     = 0.0f;
+        return;
+    }
+
+    if (now - this->windowStart < THROUGHPUT_WINDOW)
+        return;
+
+    float rate = (float)(current - this->windowProgress) * 1000.0f / (float)(now - this->windowStart);
+
+    if (this->throughput == 0.0f)
+        this->throughput = rate;
+    else
+        this->throughput = this->throughput * (1.0f - THROUGHPUT_SMOOTHING) + rate * THROUGHPUT_SMOOTHING;
+
+    this->windowStart    = now;
+    this->windowProgress = current;
+
+    this->updateReadout();
+}
+
+void ProgressDisplay::updateReadout()
+{
+    std::string text;
+
+    if (this->flags & ProgressDisplayFlags::THROUGHPUT)
+        text += formatThroughput(this->throughput);
+
+    int eta = this->getETA();
+    if ((this->flags & ProgressDisplayFlags::ETA) && eta >= 0)
+    {
+        if (!text.empty())
+            text += " - ";
+
+        text += formatDuration(eta) + " remaining";
+    }
+
+    this->readoutLabel->setText(text);
+}
+
+float ProgressDisplay::getThroughput()
+{
+    return this->throughput;
+}
+
+int ProgressDisplay::getETA()
+{
+    if (!this->source || this->throughput <= 0.0f)
+        return -1;
+
+    uint64_t current = this->source->getProgress();
+    uint64_t total   = this->source->getTotal();
+
+    if (current >= total)
+        return 0;
+
+    return (int)((float)(total - current) / this->throughput);
+}
+
 void ProgressDisplay::layout(NVGcontext* vg, Style* style, FontStash* stash)
 {
+    // The readout takes the bottom half
+    unsigned barHeight = this->readoutLabel ? this->height / 2 : this->height;
+
     if (this->label)
     {
         this->label->setWidth(style->ProgressDisplay.percentageLabelWidth);
         this->label->invalidate(true);
         this->label->setBoundaries(
             this->x + this->width - this->label->getWidth() / 2,
-            this->y + this->height / 2 - this->label->getHeight() / 2,
+            this->y + barHeight / 2 - this->label->getHeight() / 2,
             this->label->getWidth(),
             this->label->getHeight());
     }
 
+    if (this->readoutLabel)
+    {
+        this->readoutLabel->setWidth(this->width);
+        this->readoutLabel->invalidate(true);
+        this->readoutLabel->setBoundaries(
+            this->x,
+            this->y + barHeight + (this->height - barHeight) / 2 - this->readoutLabel->getHeight() / 2,
+            this->readoutLabel->getWidth(),
+            this->readoutLabel->getHeight());
+    }
+
     if (this->spinner)
     {
-        this->spinner->setWidth(this->height);
-        this->spinner->setHeight(this->height);
+        this->spinner->setWidth(barHeight);
+        this->spinner->setHeight(barHeight);
         this->spinner->setBoundaries(
             this->x,
             this->y,
@@ -73,6 +257,15 @@ void ProgressDisplay::layout(NVGcontext* vg, Style* style, FontStash* stash)
 
 void ProgressDisplay::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx)
 {
+    if (this->source)
+        this->sampleSource();
+
+    if (this->readoutLabel)
+    {
+        height /= 2;
+        this->readoutLabel->frame(ctx);
+    }
+
     unsigned progressBarWidth = width;
     unsigned progressBarX     = x;
 
@@ -129,6 +322,9 @@ ProgressDisplay::~ProgressDisplay()
 
     if (this->label)
         delete this->label;
+
+    if (this->readoutLabel)
+        delete this->readoutLabel;
 }
 
 } // namespace brls
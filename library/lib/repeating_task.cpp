@@ -18,6 +18,7 @@
 */
 
 #include <borealis/application.hpp>
+#include <borealis/clock.hpp>
 #include <borealis/repeating_task.hpp>
 
 namespace brls
@@ -38,17 +39,26 @@ void RepeatingTask::start()
 {
     this->onStart();
     this->running = true;
+
+    Application::getTaskManager()->scheduleRepeatingTask(this);
 }
 
 void RepeatingTask::pause()
 {
     this->running = false;
+
+    Application::getTaskManager()->unscheduleRepeatingTask(this);
 }
 
 void RepeatingTask::stop()
 {
+    if (this->stopRequested)
+        return;
+
     this->pause();
     this->stopRequested = true;
+
+    Application::getTaskManager()->requestStop(this);
 }
 
 void RepeatingTask::fireNow()
@@ -56,8 +66,12 @@ void RepeatingTask::fireNow()
     if (!this->isRunning())
         return;
 
-    retro_time_t currentTime = cpu_features_get_time_usec() / 1000;
+    retro_time_t currentTime = Clock::getTimeMs();
     this->run(currentTime);
+
+    // Delay the next run
+    if (this->isRunning())
+        Application::getTaskManager()->scheduleRepeatingTask(this);
 }
 
 retro_time_t RepeatingTask::getInterval()
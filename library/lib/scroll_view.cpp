@@ -19,6 +19,7 @@
 #include <math.h>
 
 #include <borealis/application.hpp>
+#include <borealis/box_layout.hpp>
 #include <borealis/scroll_view.hpp>
 
 namespace brls
@@ -114,6 +115,7 @@ void ScrollView::setContentView(View* view)
         this->contentView->willAppear(true);
     }
 
+    this->notifyFocusabilityChanged();
     this->invalidate();
 }
 
@@ -216,6 +218,24 @@ void ScrollView::onChildFocusGained(View* child)
     View::onChildFocusGained(child);
 }
 
+View* ScrollView::getNextPageFocus(FocusDirection direction, View* currentFocus)
+{
+    if (direction != FocusDirection::UP && direction != FocusDirection::DOWN)
+        return nullptr;
+
+    // Paging is only supported for box layouts, which can find
+    // the child at a given position without walking all of them
+    BoxLayout* layout = dynamic_cast<BoxLayout*>(this->contentView);
+
+    if (!this->ready || !layout)
+        return nullptr;
+
+    int page   = direction == FocusDirection::DOWN ? (int)this->height : -(int)this->height;
+    int target = (int)this->getYCenter(currentFocus) + page;
+
+    return layout->getFocusAtPosition(target, direction);
+}
+
 void ScrollView::onWindowSizeChanged()
 {
     this->updateScrollingOnNextLayout = true;
@@ -44,7 +44,7 @@ View* Sidebar::getDefaultFocus()
     View* toFocus{ nullptr };
     // Try to focus last focused one
     if(this->children.size() != 0)
-        toFocus = this->children[this->lastFocus]->view->getDefaultFocus();
+        toFocus = this->children[this->lastFocus].view->getDefaultFocus();
     
     if (toFocus)
         return toFocus;
@@ -55,7 +55,7 @@ View* Sidebar::getDefaultFocus()
 
 void Sidebar::onChildFocusGained(View* child)
 {
-    size_t position = *((size_t*)child->getParentUserData());
+    size_t position = child->getParentIndex();
 
     this->lastFocus = position;
 
@@ -17,8 +17,9 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
-#include <features/features_cpu.h>
-
+#include <algorithm>
+#include <borealis/application.hpp>
+#include <borealis/clock.hpp>
 #include <borealis/task_manager.hpp>
 
 namespace brls
@@ -26,24 +27,31 @@ namespace brls
 
 void TaskManager::frame()
 {
-    // Repeating tasks
-    retro_time_t currentTime = cpu_features_get_time_usec() / 1000;
-    for (auto i = this->repeatingTasks.begin(); i != this->repeatingTasks.end(); i++)
+    BRLS_PROFILE_SCOPE("TaskManager::frame");
+
+    // Delete the tasks stopped during the last frame
+    std::vector<RepeatingTask*> stopped;
+    stopped.swap(this->stoppedTasks);
+
+    for (RepeatingTask* task : stopped)
     {
-        RepeatingTask* task = *i;
-
-        // Stop the task if needed
-        if (task->isStopRequested())
-        {
-            this->stopRepeatingTask(task);
-            this->repeatingTasks.erase(i--);
-        }
-        // Fire it
-        else if (task->isRunning() && currentTime - task->getLastRun() > task->getInterval())
-        {
-            task->run(currentTime);
-        }
+        auto it = std::find(this->repeatingTasks.begin(), this->repeatingTasks.end(), task);
+
+        // Already stopped and deleted (stop requested twice)
+        if (it == this->repeatingTasks.end())
+            continue;
+
+        this->repeatingTasks.erase(it);
+        this->stopRepeatingTask(task);
     }
+
+    // Timers and repeating tasks that are due
+    this->timers.fire(Clock::getTimeMs());
+
+    // Completion callbacks of the thread pool tasks
+    ThreadPool* threadPool = Application::getThreadPool();
+    if (threadPool)
+        threadPool->dispatchCompletions();
 }
 
 void TaskManager::registerRepeatingTask(RepeatingTask* task)
@@ -51,6 +59,42 @@ void TaskManager::registerRepeatingTask(RepeatingTask* task)
     this->repeatingTasks.push_back(task);
 }
 
+void TaskManager::scheduleRepeatingTask(RepeatingTask* task)
+{
+    this->timers.cancel(task->timer);
+
+    task->timer = this->timers.scheduleAt(task->getLastRun() + task->getInterval(), [this, task]() {
+        task->timer = 0;
+        task->run(Clock::getTimeMs());
+
+        // The task may have been paused or stopped by its own run
+        if (task->isRunning())
+            this->scheduleRepeatingTask(task);
+    });
+}
+
+void TaskManager::unscheduleRepeatingTask(RepeatingTask* task)
+{
+    this->timers.cancel(task->timer);
+    task->timer = 0;
+}
+
+void TaskManager::requestStop(RepeatingTask* task)
+{
+    this->unscheduleRepeatingTask(task);
+    this->stoppedTasks.push_back(task);
+}
+
+TimerScheduler* TaskManager::getTimerScheduler()
+{
+    return &this->timers;
+}
+
+retro_time_t TaskManager::getNextDeadline()
+{
+    return this->timers.getNextDeadline();
+}
+
 void TaskManager::stopRepeatingTask(RepeatingTask* task)
 {
     task->onStop();
@@ -59,11 +103,14 @@ void TaskManager::stopRepeatingTask(RepeatingTask* task)
 
 TaskManager::~TaskManager()
 {
+    this->timers.clear();
+
     // Stop all repeating tasks
     for (RepeatingTask* task : this->repeatingTasks)
         this->stopRepeatingTask(task);
 
     this->repeatingTasks.clear();
+    this->stoppedTasks.clear();
 }
 
 } // namespace brls
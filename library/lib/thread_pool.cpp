@@ -0,0 +1,273 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <borealis/thread_pool.hpp>
+
+namespace brls
+{
+
+TaskHandle::TaskHandle(std::shared_ptr<PoolTask> task)
+    : task(task)
+{
+}
+
+bool TaskHandle::cancel()
+{
+    if (!this->task)
+        return false;
+
+    this->task->cancelRequested = true;
+
+    TaskStatus expected = TaskStatus::PENDING;
+    if (!this->task->status.compare_exchange_strong(expected, TaskStatus::CANCELLED))
+        return false;
+
+    std::lock_guard<std::mutex> lock(this->task->mutex);
+    this->task->doneCondition.notify_all();
+    return true;
+}
+
+bool TaskHandle::isCancelled()
+{
+    return this->task && this->task->cancelRequested;
+}
+
+bool TaskHandle::isDone()
+{
+    if (!this->task)
+        return false;
+
+    TaskStatus status = this->task->status;
+    return status == TaskStatus::DONE || status == TaskStatus::CANCELLED;
+}
+
+void TaskHandle::wait()
+{
+    if (!this->task)
+        return;
+
+    std::unique_lock<std::mutex> lock(this->task->mutex);
+    this->task->doneCondition.wait(lock, [this] { return this->isDone(); });
+}
+
+TaskStatus TaskHandle::getStatus()
+{
+    return this->task ? this->task->status.load() : TaskStatus::CANCELLED;
+}
+
+bool TaskHandle::isValid()
+{
+    return this->task != nullptr;
+}
+
+ThreadPool::ThreadPool(unsigned threadsCount)
+    : nextWorker(0)
+    , pendingTasks(0)
+    , stopping(false)
+{
+    if (threadsCount == 0)
+    {
+        unsigned cores = std::thread::hardware_concurrency();
+        threadsCount   = cores > 1 ? cores - 1 : 1;
+    }
+
+    for (unsigned i = 0; i < threadsCount; i++)
+        this->workers.push_back(std::make_unique<Worker>());
+
+    // Start the threads once all workers exist, they steal from each other
+    for (unsigned i = 0; i < threadsCount; i++)
+        this->workers[i]->thread = std::thread(&ThreadPool::workerMain, this, i);
+}
+
+TaskHandle ThreadPool::submit(std::function<void(void)> work, std::function<void(void)> completion, TaskPriority priority)
+{
+    std::shared_ptr<PoolTask> task = std::make_shared<PoolTask>();
+    task->work                     = work;
+    task->completion               = completion;
+    task->status                   = TaskStatus::PENDING;
+    task->cancelRequested          = false;
+
+    // Workers keep the tasks they submit, others are spread over all workers
+    unsigned index = ThreadPool::currentPool == this ? ThreadPool::currentWorker : this->nextWorker++ % this->workers.size();
+
+    {
+        Worker* worker = this->workers[index].get();
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->queues[(int)priority].push_back(task);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->sleepMutex);
+        this->pendingTasks++;
+    }
+
+    this->sleepCondition.notify_one();
+
+    return TaskHandle(task);
+}
+
+std::shared_ptr<PoolTask> ThreadPool::takeTask(unsigned index)
+{
+    size_t count = this->workers.size();
+
+    // Higher priorities first, from our own queue then from the others
+    for (int priority = 0; priority < BRLS_TASK_PRIORITIES; priority++)
+    {
+        {
+            Worker* worker = this->workers[index].get();
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            std::deque<std::shared_ptr<PoolTask>>& queue = worker->queues[priority];
+
+            if (!queue.empty())
+            {
+                std::shared_ptr<PoolTask> task = queue.front();
+                queue.pop_front();
+                return task;
+            }
+        }
+
+        // Steal from the back of the other queues
+        for (size_t i = 1; i < count; i++)
+        {
+            Worker* victim = this->workers[(index + i) % count].get();
+            std::lock_guard<std::mutex> lock(victim->mutex);
+            std::deque<std::shared_ptr<PoolTask>>& queue = victim->queues[priority];
+
+            if (!queue.empty())
+            {
+                std::shared_ptr<PoolTask> task = queue.back();
+                queue.pop_back();
+                return task;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+void ThreadPool::runTask(std::shared_ptr<PoolTask> task)
+{
+    // Skip cancelled tasks
+    TaskStatus expected = TaskStatus::PENDING;
+    if (!task->status.compare_exchange_strong(expected, TaskStatus::RUNNING))
+        return;
+
+    ThreadPool::currentTask = task.get();
+    task->work();
+    ThreadPool::currentTask = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->status = TaskStatus::DONE;
+        task->doneCondition.notify_all();
+    }
+
+    if (task->completion && !task->cancelRequested)
+    {
+        std::lock_guard<std::mutex> lock(this->completionsMutex);
+        this->completions.push_back(task);
+    }
+}
+
+void ThreadPool::workerMain(unsigned index)
+{
+    ThreadPool::currentPool   = this;
+    ThreadPool::currentWorker = index;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->sleepMutex);
+            this->sleepCondition.wait(lock, [this] { return this->pendingTasks > 0 || this->stopping; });
+
+            if (this->stopping)
+                return;
+
+            this->pendingTasks--;
+        }
+
+        // A task is reserved for us, but another worker may take it
+        // first from our queue: keep looking until we get one
+        std::shared_ptr<PoolTask> task;
+        while (!(task = this->takeTask(index)))
+        {
+            if (this->stopping)
+                return;
+
+            std::this_thread::yield();
+        }
+
+        this->runTask(task);
+    }
+}
+
+void ThreadPool::dispatchCompletions()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->completionsMutex);
+
+        if (this->completions.empty())
+            return;
+
+        this->completionsBuffer.swap(this->completions);
+    }
+
+    for (std::shared_ptr<PoolTask>& task : this->completionsBuffer)
+    {
+        if (!task->cancelRequested)
+            task->completion();
+    }
+
+    this->completionsBuffer.clear();
+}
+
+unsigned ThreadPool::getThreadsCount()
+{
+    return this->workers.size();
+}
+
+bool ThreadPool::isCurrentTaskCancelled()
+{
+    return ThreadPool::currentTask && ThreadPool::currentTask->cancelRequested;
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->sleepMutex);
+        this->stopping = true;
+    }
+
+    this->sleepCondition.notify_all();
+
+    for (std::unique_ptr<Worker>& worker : this->workers)
+        worker->thread.join();
+
+    // Cancel what's left so that nobody waits forever
+    for (std::unique_ptr<Worker>& worker : this->workers)
+    {
+        for (std::deque<std::shared_ptr<PoolTask>>& queue : worker->queues)
+        {
+            for (std::shared_ptr<PoolTask>& task : queue)
+                TaskHandle(task).cancel();
+        }
+    }
+}
+
+} // namespace brls
@@ -0,0 +1,145 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <algorithm>
+#include <borealis/clock.hpp>
+#include <borealis/timer_scheduler.hpp>
+#include <functional>
+
+namespace brls
+{
+
+TimerId TimerScheduler::scheduleAt(retro_time_t deadline, TimerCallback callback)
+{
+    TimerId id = this->nextId++;
+
+    this->callbacks[id] = callback;
+
+    this->heap.push_back({ deadline, id });
+    std::push_heap(this->heap.begin(), this->heap.end(), std::greater<Timer>());
+
+    return id;
+}
+
+TimerId TimerScheduler::schedule(retro_time_t delay, TimerCallback callback)
+{
+    return this->scheduleAt(Clock::getTimeMs() + delay, callback);
+}
+
+void TimerScheduler::cancel(TimerId id)
+{
+    if (this->callbacks.erase(id) == 0)
+        return;
+
+    // Don't let cancelled timers outnumber the live ones
+    if (this->heap.size() > 32 && this->heap.size() > this->callbacks.size() * 2)
+        this->compact();
+}
+
+bool TimerScheduler::isScheduled(TimerId id)
+{
+    return this->callbacks.find(id) != this->callbacks.end();
+}
+
+void TimerScheduler::compact()
+{
+    auto cancelled = [this](const Timer& timer) {
+        return this->callbacks.find(timer.id) == this->callbacks.end();
+    };
+
+    this->heap.erase(std::remove_if(this->heap.begin(), this->heap.end(), cancelled), this->heap.end());
+    std::make_heap(this->heap.begin(), this->heap.end(), std::greater<Timer>());
+}
+
+void TimerScheduler::popCancelled()
+{
+    while (!this->heap.empty() && !this->isScheduled(this->heap.front().id))
+    {
+        std::pop_heap(this->heap.begin(), this->heap.end(), std::greater<Timer>());
+        this->heap.pop_back();
+    }
+}
+
+void TimerScheduler::fire(retro_time_t currentTime)
+{
+    // Timers scheduled from a callback get a bigger id: set them
+    // aside so that a timer rescheduling itself with no delay
+    // cannot starve the frame
+    TimerId lastId = this->nextId;
+    std::vector<Timer> deferred;
+
+    while (true)
+    {
+        this->popCancelled();
+
+        if (this->heap.empty())
+            break;
+
+        Timer timer = this->heap.front();
+
+        if (timer.deadline > currentTime)
+            break;
+
+        std::pop_heap(this->heap.begin(), this->heap.end(), std::greater<Timer>());
+        this->heap.pop_back();
+
+        if (timer.id >= lastId)
+        {
+            deferred.push_back(timer);
+            continue;
+        }
+
+        // The callback is free to schedule or cancel other timers
+        auto it                = this->callbacks.find(timer.id);
+        TimerCallback callback = std::move(it->second);
+        this->callbacks.erase(it);
+
+        if (callback)
+            callback();
+    }
+
+    for (Timer& timer : deferred)
+    {
+        this->heap.push_back(timer);
+        std::push_heap(this->heap.begin(), this->heap.end(), std::greater<Timer>());
+    }
+}
+
+retro_time_t TimerScheduler::getNextDeadline()
+{
+    this->popCancelled();
+
+    if (this->heap.empty())
+        return -1;
+
+    return this->heap.front().deadline;
+}
+
+size_t TimerScheduler::getTimersCount()
+{
+    return this->callbacks.size();
+}
+
+void TimerScheduler::clear()
+{
+    this->heap.clear();
+    this->callbacks.clear();
+}
+
+} // namespace brls
@@ -22,7 +22,9 @@
 #include <algorithm>
 #include <borealis/animations.hpp>
 #include <borealis/application.hpp>
+#include <borealis/clock.hpp>
 #include <borealis/view.hpp>
+#include <borealis/view_arena.hpp>
 
 namespace brls
 {
@@ -40,7 +42,7 @@ static int shakeAnimation(float t, float a) // a = amplitude
 void View::shakeHighlight(FocusDirection direction)
 {
     this->highlightShaking        = true;
-    this->highlightShakeStart     = cpu_features_get_time_usec() / 1000;
+    this->highlightShakeStart     = Clock::getTimeMs();
     this->highlightShakeDirection = direction;
     this->highlightShakeAmplitude = std::rand() % 15 + 10;
 }
@@ -68,6 +70,8 @@ NVGpaint View::a(NVGpaint paint)
 // TODO: Only draw views that are onscreen (w/ some margins)
 void View::frame(FrameContext* ctx)
 {
+    BRLS_PROFILE_SCOPE_DETAIL("View::frame", typeid(*this).name());
+
     Style* style          = Application::getStyle();
     ThemeValues* oldTheme = ctx->theme;
 
@@ -130,7 +134,7 @@ void View::collapse(bool animated)
 
         menu_animation_ctx_entry_t entry;
 
-        entry.cb           = [](void* userdata) {};
+        entry.cb           = [this](void* userdata) { this->notifyFocusabilityChanged(); };
         entry.duration     = style->AnimationDuration.collapse;
         entry.easing_enum  = EASING_OUT_QUAD;
         entry.subject      = &this->collapseState;
@@ -144,6 +148,7 @@ void View::collapse(bool animated)
     else
     {
         this->collapseState = 0.0f;
+        this->notifyFocusabilityChanged();
     }
 }
 
@@ -163,7 +168,7 @@ void View::expand(bool animated)
 
         menu_animation_ctx_entry_t entry;
 
-        entry.cb           = [](void* userdata) {};
+        entry.cb           = [this](void* userdata) { this->notifyFocusabilityChanged(); };
         entry.duration     = style->AnimationDuration.collapse;
         entry.easing_enum  = EASING_OUT_QUAD;
         entry.subject      = &this->collapseState;
@@ -177,6 +182,7 @@ void View::expand(bool animated)
     else
     {
         this->collapseState = 1.0f;
+        this->notifyFocusabilityChanged();
     }
 }
 
@@ -200,7 +206,7 @@ void View::drawHighlight(NVGcontext* vg, ThemeValues* theme, float alpha, Style*
     // Shake animation
     if (this->highlightShaking)
     {
-        retro_time_t curTime = cpu_features_get_time_usec() / 1000;
+        retro_time_t curTime = Clock::getTimeMs();
         retro_time_t t       = (curTime - highlightShakeStart) / 10;
 
         if (t >= style->AnimationDuration.shake)
@@ -360,6 +366,8 @@ void View::registerAction(std::string hintText, Key key, ActionListener actionLi
         *it = { key, hintText, true, hidden, actionListener };
     else
         this->actions.push_back({ key, hintText, true, hidden, actionListener });
+
+    Application::invalidateActionTable(this);
 }
 
 void View::updateActionHint(Key key, std::string hintText)
@@ -374,6 +382,8 @@ void View::setActionAvailable(Key key, bool available)
 {
     if (auto it = std::find(this->actions.begin(), this->actions.end(), key); it != this->actions.end())
         it->available = available;
+
+    Application::invalidateActionTable(this);
 }
 
 void View::setBoundaries(int x, int y, unsigned width, unsigned height)
@@ -384,15 +394,22 @@ void View::setBoundaries(int x, int y, unsigned width, unsigned height)
     this->height = height;
 }
 
-void View::setParent(View* parent, void* parentUserdata)
+void View::setParent(View* parent, size_t parentIndex)
+{
+    this->parent      = parent;
+    this->parentIndex = parentIndex;
+
+    Application::invalidateActionTable(this);
+}
+
+void View::setParentIndex(size_t parentIndex)
 {
-    this->parent         = parent;
-    this->parentUserdata = parentUserdata;
+    this->parentIndex = parentIndex;
 }
 
-void* View::getParentUserData()
+size_t View::getParentIndex()
 {
-    return this->parentUserdata;
+    return this->parentIndex;
 }
 
 bool View::isFocused()
@@ -400,6 +417,16 @@ bool View::isFocused()
     return this->focused;
 }
 
+bool View::isOnFocusPath()
+{
+    return this->onFocusPath;
+}
+
+void View::setOnFocusPath(bool onFocusPath)
+{
+    this->onFocusPath = onFocusPath;
+}
+
 View* View::getParent()
 {
     return this->parent;
@@ -515,7 +542,7 @@ unsigned View::getShowAnimationDuration(ViewAnimation animation)
 
 void View::show(std::function<void(void)> cb, bool animate, ViewAnimation animation)
 {
-    brls::Logger::debug("Showing %s with animation %d", this->describe().c_str(), animation);
+    BRLS_LOG_DEBUG(LogSubsystem::VIEWS, "Showing %s with animation %d", this->describe().c_str(), animation);
 
     this->hidden = false;
 
@@ -555,7 +582,7 @@ void View::show(std::function<void(void)> cb, bool animate, ViewAnimation animat
 
 void View::hide(std::function<void(void)> cb, bool animated, ViewAnimation animation)
 {
-    brls::Logger::debug("Hiding %s with animation %d", this->describe().c_str(), animation);
+    BRLS_LOG_DEBUG(LogSubsystem::VIEWS, "Hiding %s with animation %d", this->describe().c_str(), animation);
 
     this->hidden = true;
     this->fadeIn = false;
@@ -596,6 +623,16 @@ void View::overrideThemeVariant(ThemeValues* theme)
     this->themeOverride = theme;
 }
 
+void* View::operator new(size_t size)
+{
+    return ViewArena::allocateView(size);
+}
+
+void View::operator delete(void* ptr)
+{
+    ViewArena::deallocateView(ptr);
+}
+
 View::~View()
 {
     menu_animation_ctx_tag alphaTag = (uintptr_t) & this->alpha;
@@ -607,22 +644,21 @@ View::~View()
     menu_animation_ctx_tag collapseTag = (uintptr_t) & this->collapseState;
     menu_animation_kill_by_tag(&collapseTag);
 
-    // Parent userdata
-    if (this->parentUserdata)
-    {
-        free(this->parentUserdata);
-        this->parentUserdata = nullptr;
-    }
-
     // Focus sanity check
     if (Application::getCurrentFocus() == this)
         Application::giveFocus(nullptr);
+
+    Application::invalidateActionTable(this);
 }
 
 void View::invalidate(bool immediate)
 {
     if (immediate)
+    {
+        BRLS_PROFILE_SCOPE_DETAIL("View::layout", typeid(*this).name());
+        Application::countLayout();
         this->layout(Application::getNVGContext(), Application::getStyle(), Application::getFontStash());
+    }
     else
         this->dirty = true;
 }
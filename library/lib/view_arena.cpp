@@ -0,0 +1,224 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <borealis/logger.hpp>
+#include <borealis/view.hpp>
+#include <borealis/view_arena.hpp>
+#include <cstddef>
+
+namespace brls
+{
+
+// Put in front of every view allocation
+struct alignas(alignof(std::max_align_t)) ViewAllocationHeader
+{
+    ViewArena* arena; // nullptr for heap allocations
+    size_t size; // including the header
+};
+
+// Statistics of the views allocated outside of any arena,
+// which can happen on any thread
+static std::atomic<size_t> heapAllocations;
+static std::atomic<size_t> heapLiveAllocations;
+static std::atomic<size_t> heapBytesAllocated;
+static std::atomic<size_t> heapLiveBytes;
+
+static size_t alignSize(size_t size)
+{
+    size_t alignment = alignof(std::max_align_t);
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+float ViewArenaStats::getFragmentation() const
+{
+    if (this->bytesReserved == 0)
+        return 0.0f;
+
+    return 1.0f - (float)this->liveBytes / (float)this->bytesReserved;
+}
+
+ViewArena::ViewArena(size_t blockSize)
+    : blockSize(blockSize)
+{
+}
+
+void* ViewArena::allocate(size_t size)
+{
+    size = alignSize(size);
+
+    // Start a new block if needed - big allocations get their own
+    if (this->blocks.empty() || this->blockOffset + size > this->blockCapacity)
+    {
+        size_t capacity = size > this->blockSize ? size : this->blockSize;
+        char* block     = (char*)malloc(capacity);
+
+        if (!block)
+            return nullptr;
+
+        this->blocks.push_back(block);
+        this->blockOffset   = 0;
+        this->blockCapacity = capacity;
+
+        this->stats.bytesReserved += capacity;
+        this->stats.blocks++;
+    }
+
+    void* ptr = this->blocks.back() + this->blockOffset;
+    this->blockOffset += size;
+
+    this->stats.allocations++;
+    this->stats.liveAllocations++;
+    this->stats.bytesAllocated += size;
+    this->stats.liveBytes += size;
+
+    return ptr;
+}
+
+void ViewArena::deallocate(size_t size)
+{
+    this->stats.liveAllocations--;
+    this->stats.liveBytes -= alignSize(size);
+
+    if (this->references == 0 && this->stats.liveAllocations == 0)
+        delete this;
+}
+
+void ViewArena::retain()
+{
+    this->references++;
+}
+
+void ViewArena::release()
+{
+    if (this->references > 0)
+        this->references--;
+
+    if (this->references == 0 && this->stats.liveAllocations == 0)
+        delete this;
+}
+
+ViewArenaStats ViewArena::getStats()
+{
+    return this->stats;
+}
+
+ViewArena* ViewArena::getCurrent()
+{
+    return ViewArena::current;
+}
+
+ViewArena* ViewArena::getArena(View* view)
+{
+    // The allocation starts at the most derived object
+    char* ptr                    = (char*)dynamic_cast<void*>(view);
+    ViewAllocationHeader* header = (ViewAllocationHeader*)(ptr - sizeof(ViewAllocationHeader));
+
+    return header->arena;
+}
+
+ViewArenaStats ViewArena::getHeapStats()
+{
+    ViewArenaStats stats;
+
+    stats.allocations     = heapAllocations.load(std::memory_order_relaxed);
+    stats.liveAllocations = heapLiveAllocations.load(std::memory_order_relaxed);
+    stats.bytesAllocated  = heapBytesAllocated.load(std::memory_order_relaxed);
+    stats.liveBytes       = heapLiveBytes.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+void* ViewArena::allocateView(size_t size)
+{
+    size_t totalSize             = sizeof(ViewAllocationHeader) + size;
+    ViewArena* arena             = ViewArena::current;
+    ViewAllocationHeader* header = nullptr;
+
+    if (arena)
+    {
+        header = (ViewAllocationHeader*)arena->allocate(totalSize);
+    }
+    else
+    {
+        header = (ViewAllocationHeader*)malloc(totalSize);
+
+        heapAllocations.fetch_add(1, std::memory_order_relaxed);
+        heapLiveAllocations.fetch_add(1, std::memory_order_relaxed);
+        heapBytesAllocated.fetch_add(totalSize, std::memory_order_relaxed);
+        heapLiveBytes.fetch_add(totalSize, std::memory_order_relaxed);
+    }
+
+    if (!header)
+    {
+        Logger::error("Cannot allocate %zu bytes for a view", size);
+        abort();
+    }
+
+    header->arena = arena;
+    header->size  = totalSize;
+
+    return header + 1;
+}
+
+void ViewArena::deallocateView(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    ViewAllocationHeader* header = (ViewAllocationHeader*)ptr - 1;
+
+    if (header->arena)
+    {
+        header->arena->deallocate(header->size);
+    }
+    else
+    {
+        heapLiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+        heapLiveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+
+        free(header);
+    }
+}
+
+ViewArena::~ViewArena()
+{
+    Logger::debug("Freeing view arena: %zu allocations, %zu bytes in %zu blocks",
+        this->stats.allocations,
+        this->stats.bytesReserved,
+        this->stats.blocks);
+
+    for (char* block : this->blocks)
+        free(block);
+}
+
+ViewArenaScope::ViewArenaScope(ViewArena* arena)
+    : previous(ViewArena::current)
+{
+    ViewArena::current = arena;
+}
+
+ViewArenaScope::~ViewArenaScope()
+{
+    ViewArena::current = this->previous;
+}
+
+} // namespace brls
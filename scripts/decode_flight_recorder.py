@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""Decodes a borealis flight recorder dump (borealis_flight.bin).
+
+Usage: decode_flight_recorder.py [--frames] dump.bin
+
+Prints the recorded events in chronological order, followed by
+a summary of the frame timings. Times are relative to the last
+recorded event. Type names are demangled if c++filt is available.
+"""
+
+from __future__ import print_function
+
+import argparse
+import shutil
+import struct
+import subprocess
+import sys
+
+MAGIC = b"BRLSFLT1"
+
+EVENT_TYPES = ["LOG", "FOCUS", "PUSH", "POP", "SLOW_FRAME", "CRASH", "SIGNAL"]
+LOG_LEVELS = ["ERROR", "INFO", "DEBUG"]
+
+# sequence, timestamp, type, value, pointer - followed by the text
+EVENT_HEADER = struct.Struct("<QQIIQ")
+FRAME = struct.Struct("<QII")
+
+
+def demangle(names):
+    if not names or not shutil.which("c++filt"):
+        return {}
+
+    names = sorted(names)
+    try:
+        output = subprocess.run(["c++filt", "-t"], input="\n".join(names), stdout=subprocess.PIPE, universal_newlines=True, check=True).stdout
+    except (OSError, subprocess.CalledProcessError):
+        return {}
+
+    return dict(zip(names, output.splitlines()))
+
+
+def read_dump(path):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if data[:8] != MAGIC:
+        sys.exit("%s: not a flight recorder dump" % path)
+
+    event_size, events_count, frame_size, frames_count = struct.unpack_from("<IIII", data, 8)
+    (next_frame,) = struct.unpack_from("<Q", data, 24)
+    offset = 32
+
+    events = []
+    for i in range(events_count):
+        base = offset + i * event_size
+        sequence, timestamp, type, value, pointer = EVENT_HEADER.unpack_from(data, base)
+        text = data[base + EVENT_HEADER.size : base + event_size].split(b"\0", 1)[0].decode("utf-8", "replace")
+
+        # Never written, or torn by a crash in the middle of the write
+        if sequence == 0 or (sequence - 1) % events_count != i:
+            continue
+
+        events.append((sequence, timestamp, type, value, pointer, text))
+
+    events.sort()
+
+    offset += events_count * event_size
+
+    frames = []
+    first_frame = max(0, next_frame - frames_count)
+    for index in range(first_frame, next_frame):
+        frames.append(FRAME.unpack_from(data, offset + (index % frames_count) * frame_size))
+
+    return events, frames
+
+
+def describe(type, value, pointer, text, names):
+    name = EVENT_TYPES[type] if type < len(EVENT_TYPES) else "TYPE %d" % type
+    view = "%s (0x%x)" % (names.get(text, text), pointer)
+
+    if name == "LOG":
+        level = LOG_LEVELS[value] if value < len(LOG_LEVELS) else str(value)
+        return "%-10s [%s] %s" % (name, level, text)
+    elif name == "FOCUS":
+        return "%-10s %s" % (name, view if pointer else "none")
+    elif name in ("PUSH", "POP"):
+        return "%-10s %s, stack size %d" % (name, view, value)
+    elif name == "SLOW_FRAME":
+        return "%-10s %.2f ms (%s)" % (name, value / 1000.0, text)
+    elif name == "SIGNAL":
+        return "%-10s %d" % (name, value)
+
+    return "%-10s %s" % (name, text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decodes a borealis flight recorder dump")
+    parser.add_argument("dump", help="the dump file")
+    parser.add_argument("--frames", action="store_true", help="print every recorded frame")
+    args = parser.parse_args()
+
+    events, frames = read_dump(args.dump)
+
+    names = demangle(set(e[5] for e in events if EVENT_TYPES[e[2]] in ("FOCUS", "PUSH", "POP") and e[5]))
+
+    end = events[-1][1] if events else (frames[-1][0] if frames else 0)
+
+    print("Events (%d):" % len(events))
+    for sequence, timestamp, type, value, pointer, text in events:
+        print("  %10.3f s  %s" % ((timestamp - end) / 1000000.0, describe(type, value, pointer, text, names)))
+
+    print()
+    print("Frames (%d):" % len(frames))
+
+    if not frames:
+        return
+
+    if args.frames:
+        for timestamp, interval, work in frames:
+            print("  %10.3f s  interval %7.2f ms  work %7.2f ms" % ((timestamp - end) / 1000000.0, interval / 1000.0, work / 1000.0))
+
+    intervals = sorted(f[1] for f in frames if f[1] > 0)
+    works = sorted(f[2] for f in frames)
+
+    def stats(name, values):
+        if not values:
+            return
+        print(
+            "  %-8s mean %7.2f ms  p50 %7.2f ms  p99 %7.2f ms  max %7.2f ms"
+            % (name, sum(values) / len(values) / 1000.0, values[len(values) // 2] / 1000.0, values[len(values) * 99 // 100] / 1000.0, values[-1] / 1000.0)
+        )
+
+    stats("interval", intervals)
+    stats("work", works)
+
+
+if __name__ == "__main__":
+    main()